@@ -0,0 +1,15 @@
+# libtiff is only used by the encoder to read Aperio SVS files natively.
+# It is not built from source; when it cannot be found the encoder
+# falls back to reading SVS files through OpenSlide.
+message(STATUS "Looking for libtiff...")
+find_package(TIFF)
+if (TIFF_FOUND)
+    message(STATUS "libtiff FOUND: version ${TIFF_VERSION}")
+    set(IRIS_INCLUDE_TIFF ON)
+    include_directories(
+        ${TIFF_INCLUDE_DIRS}
+    )
+else ()
+    message(STATUS "libtiff NOT FOUND. Aperio SVS files will be read through OpenSlide.")
+    set(IRIS_INCLUDE_TIFF OFF)
+endif()
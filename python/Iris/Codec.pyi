@@ -238,10 +238,52 @@ class Slide:
     @typing.overload
     def read_slide_tile(self, layer_index: int = 0, x_tile_index: int = 0, y_tile_index: int = 0) -> numpy.typing.NDArray[numpy.uint8]:
         ...
+    def read_slide_tile_scaled(self, layer_index: int, tile_index: int, scale: int) -> numpy.typing.NDArray[numpy.uint8]:
+        """
+        Returns a [256/scale,256/scale,4] numpy array of a slide tile decoded at 1/scale resolution. The scale must be 1, 2, 4, or 8
+        """
+    def read_slide_tiles(self, layer_index: int, tile_indices: list[int]) -> list[numpy.typing.NDArray[numpy.uint8]]:
+        """
+        Returns a list of [256,256,4] numpy arrays for the given tile indices within a layer. Tiles are decoded in parallel; failed tiles are returned as empty arrays
+        """
+    def set_tile_cache_budget(self, bytes: int) -> Result:
+        """
+        Set the byte budget of the slide's decoded tile cache. A budget of zero disables the cache
+        """
+    def get_tile_cache_stats(self) -> tuple[Result, TileCacheStats]:
+        """
+        Returns a Result and the decoded tile cache statistics
+        """
+    def read_slide_region(self, layer_index: int, x: int, y: int, width: int, height: int) -> numpy.typing.NDArray[numpy.uint8]:
+        """
+        Returns an arbitrary pixel region of a layer as a [height,width,4] numpy array. Only the tiles the region touches are decoded, in parallel
+        """
     def read_slide_tile_channels(self, layer_index: int = 0, tile_index: int = 0) -> numpy.typing.NDArray[numpy.uint8]:
         """
         Returns slide tile pixel data in the form of a [4,256,256] numpy array with each major
         """
+class TileCacheStats:
+    """
+    Decoded tile cache usage (in bytes) and hit, miss, and eviction counts for a slide
+    """
+    @property
+    def budget(self) -> int:
+        ...
+    @property
+    def bytes(self) -> int:
+        ...
+    @property
+    def entries(self) -> int:
+        ...
+    @property
+    def hits(self) -> int:
+        ...
+    @property
+    def misses(self) -> int:
+        ...
+    @property
+    def evictions(self) -> int:
+        ...
 class SlideInfo:
     """
     Basic slide information that includes the version of Iris Codec used to encode the slide file, the slide extent, both in lowest resolution pixels and layers comprising number of 256 pixel tiles
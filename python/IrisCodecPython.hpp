@@ -69,7 +69,7 @@ inline py::array_t<uint8_t> _read_slide_tile_coords (const Slide& __sl, const un
     auto shape  = std::vector<size_t>{TILE_PIX_LENGTH,TILE_PIX_LENGTH,4};
     auto array  = py::array_t<uint8_t>(shape);
     auto buffer = Iris::Wrap_weak_buffer_fom_data(array.data(0), array.size());
-    auto extent = __sl->get_slide_info().extent;
+    auto& extent = __sl->get_slide_extent();
     if (__li >= extent.layers.size()) { printf
         ("read_slide_tile error: layer index (%u) out of bounds", __li);
         return array;
@@ -95,6 +95,107 @@ inline py::array_t<uint8_t> _read_slide_tile_coords (const Slide& __sl, const un
     }
     return array;
 }
+inline py::array_t<uint8_t> _read_slide_tile_scaled (const Slide& __sl, const unsigned __li, const unsigned __ti, const unsigned __scale)
+{
+    switch (__scale) {
+        case DECODE_SCALE_FULL:
+        case DECODE_SCALE_HALF:
+        case DECODE_SCALE_QUARTER:
+        case DECODE_SCALE_EIGHTH: break;
+        default: printf
+            ("read_slide_tile_scaled error: scale denominator (%u) must be 1, 2, 4, or 8", __scale);
+            return py::array_t<uint8_t>();
+    }
+    const size_t length = TILE_PIX_LENGTH / __scale;
+    auto shape  = std::vector<size_t>{length,length,4};
+    auto array  = py::array_t<uint8_t>(shape);
+    auto buffer = Iris::Wrap_weak_buffer_fom_data(array.data(0), array.size());
+    auto pixels = read_slide_tile( SlideTileReadInfo {
+        .slide                  = __sl,
+        .layerIndex             = __li,
+        .tileIndex              = __ti,
+        .optionalDestination    = buffer,
+        .desiredFormat          = Iris::FORMAT_R8G8B8A8
+    }, static_cast<DecodeScale>(__scale));
+    if (buffer != pixels) {
+        printf("Failed to read slide pixel values into destination buffer; buffer was insuffiently sized");
+        return py::array_t<uint8_t>();
+    }
+    return array;
+}
+inline py::list _read_slide_tiles (const Slide& __sl, const unsigned __li, const std::vector<uint32_t>& __tis)
+{
+    // Allocate the numpy destinations while holding the GIL, then release it
+    // so the batch can decode across the codec context worker threads.
+    auto shape  = std::vector<size_t>{TILE_PIX_LENGTH,TILE_PIX_LENGTH,4};
+    auto arrays = std::vector<py::array_t<uint8_t>>();
+    auto buffers= std::vector<Buffer>();
+    arrays.reserve(__tis.size());
+    buffers.reserve(__tis.size());
+    for (size_t index = 0; index < __tis.size(); ++index) {
+        auto& array = arrays.emplace_back(shape);
+        buffers.push_back(Iris::Wrap_weak_buffer_fom_data(array.mutable_data(0), array.size()));
+    }
+    
+    SlideTileReadResults results;
+    {
+        py::gil_scoped_release release;
+        results = read_slide_tiles( SlideTilesReadInfo {
+            .slide                  = __sl,
+            .layerIndex             = __li,
+            .tileIndices            = __tis,
+            .optionalDestinations   = buffers,
+            .desiredFormat          = Iris::FORMAT_R8G8B8A8
+        });
+    }
+    
+    py::list tiles;
+    for (size_t index = 0; index < results.size(); ++index) {
+        auto& result = results[index];
+        if (result.result != IRIS_SUCCESS || result.pixels != buffers[index]) {
+            printf("Failed to read slide tile %u: %s\n", result.tileIndex, result.result.message.c_str());
+            tiles.append(py::array_t<uint8_t>());
+        } else tiles.append(arrays[index]);
+    }
+    return tiles;
+}
+inline py::array_t<uint8_t> _read_slide_region (const Slide& __sl, const unsigned __li,
+                                                 const unsigned __x, const unsigned __y,
+                                                 const unsigned __w, const unsigned __h)
+{
+    auto shape  = std::vector<size_t>{__h,__w,4};
+    auto array  = py::array_t<uint8_t>(shape);
+    auto buffer = Iris::Wrap_weak_buffer_fom_data(array.mutable_data(0), array.size());
+    Buffer pixels;
+    {
+        py::gil_scoped_release release;
+        pixels = read_slide_region( SlideRegionReadInfo {
+            .slide                  = __sl,
+            .layerIndex             = __li,
+            .xOffset                = __x,
+            .yOffset                = __y,
+            .width                  = __w,
+            .height                 = __h,
+            .optionalDestination    = buffer,
+            .desiredFormat          = Iris::FORMAT_R8G8B8A8
+        });
+    }
+    if (buffer != pixels) {
+        printf("Failed to read slide region pixel values into destination buffer");
+        return py::array_t<uint8_t>();
+    }
+    return array;
+}
+inline Result _set_tile_cache_budget (const Slide& __sl, const size_t __bytes)
+{
+    return set_slide_tile_cache_budget(__sl, __bytes);
+}
+inline std::tuple<Result, TileCacheStats> _get_tile_cache_stats (const Slide& __sl)
+{
+    TileCacheStats stats;
+    return std::tuple<Result,TileCacheStats>
+        (get_slide_tile_cache_stats(__sl, stats),stats);
+}
 inline py::array_t<uint8_t> _read_slide_tile_channels (const Slide& __sl, const unsigned __li, const unsigned __ti)
 {
     auto buffer = read_slide_tile( SlideTileReadInfo {
@@ -350,6 +451,15 @@ static inline void DEFINE_IRIS_CODEC_SUBMODULE (pybind11::module_& base)
         .def_readonly("source_format",      &AssociatedImageInfo::sourceFormat);
 //        .def_readonly("orientation",        &AssociatedImageInfo::orientation);
     
+    py::class_<TileCacheStats>                              (m, "TileCacheStats")
+        .def_readonly("budget",             &TileCacheStats::budget)
+        .def_readonly("bytes",              &TileCacheStats::bytes)
+        .def_readonly("entries",            &TileCacheStats::entries)
+        .def_readonly("hits",               &TileCacheStats::hits)
+        .def_readonly("misses",             &TileCacheStats::misses)
+        .def_readonly("evictions",          &TileCacheStats::evictions)
+        .doc() = "Decoded tile cache usage (in bytes) and hit, miss, and eviction counts for a slide";
+    
     py::class_<Codec::__INTERNAL__Context,  Codec::Context> (m, "Context")
         .doc() = "Iris Codec Context helper class used for access to GPU encoding and decoding methods. Use of a context is most beneficial when encoding or decoding multiple files as it can optimize and orchistrate an encoding queue.";
     
@@ -362,10 +472,31 @@ static inline void DEFINE_IRIS_CODEC_SUBMODULE (pybind11::module_& base)
              py::arg("layer_index") = 0,
              py::arg("x_tile_index")= 0,
              py::arg("y_tile_index")= 0)
+        .def("read_slide_tile_scaled",      &_read_slide_tile_scaled,
+             "Returns a [256/scale,256/scale,4] numpy array of a slide tile decoded at 1/scale resolution. The scale must be 1, 2, 4, or 8",
+             py::arg("layer_index"),
+             py::arg("tile_index"),
+             py::arg("scale"))
+        .def("read_slide_tiles",            &_read_slide_tiles,
+             "Returns a list of [256,256,4] numpy arrays for the given tile indices within a layer. Tiles are decoded in parallel; failed tiles are returned as empty arrays",
+             py::arg("layer_index"),
+             py::arg("tile_indices"))
+        .def("read_slide_region",           &_read_slide_region,
+             "Returns an arbitrary pixel region of a layer as a [height,width,4] numpy array. Only the tiles the region touches are decoded, in parallel",
+             py::arg("layer_index"),
+             py::arg("x"),
+             py::arg("y"),
+             py::arg("width"),
+             py::arg("height"))
         .def("read_slide_tile_channels",    &_read_slide_tile_channels,
              "Returns slide tile pixel data in the form of a [4,256,256] numpy array with each major",
              py::arg("layer_index") = 0,
              py::arg("tile_index")  = 0)
+        .def("set_tile_cache_budget",       &_set_tile_cache_budget,
+             "Set the byte budget of the slide's decoded tile cache. A budget of zero disables the cache",
+             py::arg("bytes"))
+        .def("get_tile_cache_stats",        &_get_tile_cache_stats,
+             "Returns a Result and the decoded tile cache statistics")
         .def("get_associated_image_info",   &_get_associated_image_info,
              "Return image information about an associated image such as label or thumbnail",
              py::arg("image_label"))
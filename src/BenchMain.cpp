@@ -0,0 +1,429 @@
+/**
+ * @file BenchMain.cpp
+ * @author Ryan Landvater
+ * @brief
+ * @version 2025.1.0
+ * @date 2026-10-17
+ *
+ * Iris Codec microbenchmarks. Built only with IRIS_BUILD_BENCHMARKS;
+ * each benchmark compares a codec path against the implementation it
+ * replaced on a fixed, generated workload so runs are comparable.
+ *
+ * @copyright Copyright (c) Ryan Landvater, 2025
+ *
+ */
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <cstring>
+#include <filesystem>
+#include <turbojpeg.h>
+
+#include "IrisCodecPriv.hpp"
+constexpr char help_statement[] =
+"Iris Codec Bench measures the throughput of Iris Codec internals against\
+ the implementations they replaced.\n \
+Usage: IrisCodecBench <benchmark> [arguments]\n \
+Benchmarks:\n \
+jpeg: Encode and decode 256 px tiles with a TurboJPEG handle created per call and with the context's pooled handles\n \
+convert: Convert 256 px tiles between pixel formats with convert_pixel_format and with a scalar loop\n \
+write: Encode one source slide into each output directory with the mapped, pwrite and direct write \
+backends (ex. -o /dev/shm -o /mnt/disk to compare tmpfs against disk); requires IRIS_BUILD_ENCODER\n \
+Arugments:\n \
+-h --help: Print this help text \n \
+-t --threads: Worker threads (defaults to all cores)\n \
+-n --tiles: Distinct generated tiles in the workload (default 64)\n \
+-p --passes: Passes over the workload per measurement (default 16)\n \
+-s --source: Source slide file to encode (write)\n \
+-o --outdir: Output directory to encode into; may be given more than once (write)\n \
+\n";
+using namespace IrisCodec;
+using Clock = std::chrono::steady_clock;
+struct BenchOptions {
+    size_t      threads     = std::max(1U, std::thread::hardware_concurrency());
+    size_t      tiles       = 64;
+    size_t      passes      = 16;
+    std::string source;
+    std::vector<std::string> outdirs;
+};
+// MARK: - BENCHMARK HARNESS
+/// Run work items [0, count) on the given number of threads and return
+/// the elapsed wall time in seconds.
+template <class Work>
+inline double RUN_PARALLEL (size_t threads, size_t count, const Work& work)
+{
+    std::atomic<size_t> next (0);
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    const auto start = Clock::now();
+    for (size_t thread = 0; thread < threads; ++thread)
+        workers.emplace_back([&](){
+            for (size_t index; (index = next.fetch_add(1)) < count;)
+                work(index);
+        });
+    for (auto& worker : workers) worker.join();
+    const std::chrono::duration<double> elapsed = Clock::now() - start;
+    return elapsed.count();
+}
+inline void REPORT_RATE (const std::string& name, double items, double seconds,
+                         const char* unit, double baseline = 0.0)
+{
+    const double rate = items / std::max(seconds, 1E-9);
+    std::cout   << "  " << std::left << std::setw(40) << name << std::right
+                << std::fixed << std::setprecision(1) << std::setw(12) << rate
+                << " " << unit;
+    if (baseline > 0.0)
+        std::cout << "  (" << std::setprecision(2) << rate / baseline << "x)";
+    std::cout << "\n" << std::defaultfloat;
+}
+/// Generate tiles with smooth gradients and a little deterministic noise,
+/// so that they compress roughly like tissue rather than flat color.
+inline std::vector<Buffer> GENERATE_TILES (size_t count, size_t channels)
+{
+    std::vector<Buffer> tiles (count);
+    uint32_t state = 0x9E3779B9;
+    for (size_t tile = 0; tile < count; ++tile) {
+        auto& buffer = tiles[tile] = Create_strong_buffer(TILE_PIX_AREA * channels);
+        buffer->set_size(TILE_PIX_AREA * channels);
+        auto pixels = static_cast<BYTE*>(buffer->data());
+        for (uint32_t y = 0; y < TILE_PIX_LENGTH; ++y)
+            for (uint32_t x = 0; x < TILE_PIX_LENGTH; ++x)
+                for (size_t c = 0; c < channels; ++c) {
+                    state ^= state << 13; state ^= state >> 17; state ^= state << 5;
+                    const uint32_t base = (x * (c + 1) + y * (3 - c % 3) + tile * 37) & 0xFF;
+                    *pixels++ = static_cast<BYTE>((base + (state & 0x0F)) & 0xFF);
+                }
+    }
+    return tiles;
+}
+// MARK: - JPEG HANDLE POOLING
+constexpr int BENCH_JPEG_QUALITY = 90;
+/// Compress as COMPRESS_JPEG did before handles were pooled: a new
+/// TurboJPEG compressor and destination for every tile.
+inline Buffer COMPRESS_JPEG_PER_CALL (const Buffer& pixels)
+{
+    auto dst = Create_strong_buffer(tjBufSize(TILE_PIX_LENGTH, TILE_PIX_LENGTH, TJSAMP_422));
+    tjhandle turbo_handle = tj3Init(TJINIT_COMPRESS);
+    if (turbo_handle == NULL) throw std::runtime_error("Failed to create a TURBO_JPEG Context");
+    size_t size     = dst->capacity();
+    auto   dst_ptr  = static_cast<BYTE*>(dst->data());
+    tj3Set(turbo_handle, TJPARAM_NOREALLOC, 1);
+    tj3Set(turbo_handle, TJPARAM_QUALITY, BENCH_JPEG_QUALITY);
+    tj3Set(turbo_handle, TJPARAM_SUBSAMP, TJSAMP_422);
+    const int failed = tj3Compress8(turbo_handle, static_cast<BYTE*>(pixels->data()),
+                                    TILE_PIX_LENGTH, 0, TILE_PIX_LENGTH, TJPF_RGB,
+                                    &dst_ptr, &size);
+    tj3Destroy(turbo_handle);
+    if (failed) throw std::runtime_error("TURBO_JPEG failed to compress tile data");
+    dst->set_size(size);
+    return dst;
+}
+/// Decompress as DECOMPRESS_JPEG did before handles were pooled
+inline Buffer DECOMPRESS_JPEG_PER_CALL (const Buffer& compressed, const Buffer& dst)
+{
+    tjhandle turbo_handle = tj3Init(TJINIT_DECOMPRESS);
+    if (turbo_handle == NULL) throw std::runtime_error("Failed to create a TURBO_JPEG Context");
+    const int failed =
+        tj3DecompressHeader(turbo_handle, static_cast<BYTE*>(compressed->data()), compressed->size()) ||
+        tj3Decompress8(turbo_handle, static_cast<BYTE*>(compressed->data()), compressed->size(),
+                       static_cast<BYTE*>(dst->data()), 0, TJPF_RGB);
+    tj3Destroy(turbo_handle);
+    if (failed) throw std::runtime_error("TURBO_JPEG failed to decompress tile data");
+    dst->set_size(TILE_PIX_AREA * 3);
+    return dst;
+}
+inline void BENCH_JPEG (const BenchOptions& options)
+{
+    auto context = create_context();
+    if (!context) throw std::runtime_error("Failed to create a codec context");
+    context->set_quality(BENCH_JPEG_QUALITY);
+    context->set_subsampling(SUBSAMPLE_422);
+
+    const auto tiles  = GENERATE_TILES(options.tiles, 3);
+    const auto count  = options.tiles * options.passes;
+    std::vector<Buffer> compressed (tiles.size());
+    for (size_t tile = 0; tile < tiles.size(); ++tile)
+        compressed[tile] = COMPRESS_JPEG_PER_CALL(tiles[tile]);
+
+    std::cout   << "JPEG 256 px RGB tiles, quality " << BENCH_JPEG_QUALITY << " 4:2:2, "
+                << options.threads << " threads, " << count << " tiles per run\n";
+    const double encode_per_call = RUN_PARALLEL(options.threads, count, [&](size_t index) {
+        COMPRESS_JPEG_PER_CALL(tiles[index % tiles.size()]);
+    });
+    const double encode_pooled = RUN_PARALLEL(options.threads, count, [&](size_t index) {
+        context->compress_tile(CompressTileInfo {
+            .pixelArray     = tiles[index % tiles.size()],
+            .format         = Iris::FORMAT_R8G8B8,
+            .encoding       = TILE_ENCODING_JPEG,
+            .quality        = BENCH_JPEG_QUALITY,
+            .subsampling    = SUBSAMPLE_422,
+        });
+    });
+    const double decode_per_call = RUN_PARALLEL(options.threads, count, [&](size_t index) {
+        thread_local Buffer scratch = Create_strong_buffer(TILE_PIX_AREA * 3);
+        DECOMPRESS_JPEG_PER_CALL(compressed[index % compressed.size()], scratch);
+    });
+    const double decode_pooled = RUN_PARALLEL(options.threads, count, [&](size_t index) {
+        thread_local Buffer scratch = Create_strong_buffer(TILE_PIX_AREA * 3);
+        context->decompress_tile(DecompressTileInfo {
+            .compressed             = compressed[index % compressed.size()],
+            .optionalDestination    = scratch,
+            .desiredFormat          = Iris::FORMAT_R8G8B8,
+            .encoding               = TILE_ENCODING_JPEG,
+        });
+    });
+    const double per_call_encode_rate = count / encode_per_call;
+    const double per_call_decode_rate = count / decode_per_call;
+    REPORT_RATE("encode, tj3Init per call",  count, encode_per_call, "tiles/s");
+    REPORT_RATE("encode, pooled handles",    count, encode_pooled,   "tiles/s", per_call_encode_rate);
+    REPORT_RATE("decode, tj3Init per call",  count, decode_per_call, "tiles/s");
+    REPORT_RATE("decode, pooled handles",    count, decode_pooled,   "tiles/s", per_call_decode_rate);
+}
+// MARK: - PIXEL FORMAT CONVERSION
+inline size_t BENCH_CHANNELS (Format format)
+{
+    switch (format) {
+        case Iris::FORMAT_R8G8B8:
+        case Iris::FORMAT_B8G8R8:   return 3;
+        case Iris::FORMAT_R8G8B8A8:
+        case Iris::FORMAT_B8G8R8A8: return 4;
+        default:                    return 0;
+    }
+}
+inline bool BENCH_BGR_ORDER (Format format)
+{
+    return format == Iris::FORMAT_B8G8R8 || format == Iris::FORMAT_B8G8R8A8;
+}
+/// Per pixel reference conversion; in place is safe as each pixel is
+/// read in full before it is written and pixels never grow in place.
+inline void CONVERT_PIXELS_SCALAR (const BYTE* source, BYTE* destination, size_t pixels,
+                                   Format initial, Format desired)
+{
+    const size_t src_channels = BENCH_CHANNELS(initial);
+    const size_t dst_channels = BENCH_CHANNELS(desired);
+    const bool   src_bgr      = BENCH_BGR_ORDER(initial);
+    const bool   dst_bgr      = BENCH_BGR_ORDER(desired);
+    for (size_t pixel = 0; pixel < pixels; ++pixel) {
+        const BYTE* src = source + pixel * src_channels;
+        BYTE*       dst = destination + pixel * dst_channels;
+        const BYTE  red     = src[src_bgr ? 2 : 0];
+        const BYTE  green   = src[1];
+        const BYTE  blue    = src[src_bgr ? 0 : 2];
+        const BYTE  alpha   = src_channels == 4 ? src[3] : 0xFF;
+        dst[dst_bgr ? 2 : 0] = red;
+        dst[1]               = green;
+        dst[dst_bgr ? 0 : 2] = blue;
+        if (dst_channels == 4) dst[3] = alpha;
+    }
+}
+inline void BENCH_CONVERT (const BenchOptions& options)
+{
+    struct Pair {
+        const char* name;
+        Format      initial;
+        Format      desired;
+        bool        inPlace;
+    };
+    const Pair pairs[] = {
+        {"RGB  -> BGR",                 Iris::FORMAT_R8G8B8,   Iris::FORMAT_B8G8R8,   false},
+        {"BGR  -> RGB",                 Iris::FORMAT_B8G8R8,   Iris::FORMAT_R8G8B8,   false},
+        {"RGBA -> BGRA",                Iris::FORMAT_R8G8B8A8, Iris::FORMAT_B8G8R8A8, false},
+        {"RGB  -> RGBA (alpha fill)",   Iris::FORMAT_R8G8B8,   Iris::FORMAT_R8G8B8A8, false},
+        {"RGB  -> BGRA (alpha fill)",   Iris::FORMAT_R8G8B8,   Iris::FORMAT_B8G8R8A8, false},
+        {"RGBA -> RGB  (drop alpha)",   Iris::FORMAT_R8G8B8A8, Iris::FORMAT_R8G8B8,   false},
+        {"BGRA -> RGB  (drop alpha)",   Iris::FORMAT_B8G8R8A8, Iris::FORMAT_R8G8B8,   false},
+        {"RGB  -> BGR  in place",       Iris::FORMAT_R8G8B8,   Iris::FORMAT_B8G8R8,   true},
+        {"RGBA -> BGRA in place",       Iris::FORMAT_R8G8B8A8, Iris::FORMAT_B8G8R8A8, true},
+    };
+    const auto rgb    = GENERATE_TILES(options.tiles, 3);
+    const auto rgba   = GENERATE_TILES(options.tiles, 4);
+    const auto count  = options.tiles * options.passes;
+    const double megapixels = count * static_cast<double>(TILE_PIX_AREA) / 1E6;
+
+    std::cout   << "Pixel format conversion of 256 px tiles, " << options.threads
+                << " threads, " << count << " tiles per run\n";
+    for (auto& pair : pairs) {
+        const auto& tiles = BENCH_CHANNELS(pair.initial) == 3 ? rgb : rgba;
+        const size_t dst_bytes = TILE_PIX_AREA * BENCH_CHANNELS(pair.desired);
+        
+        // Both paths must agree before either is timed
+        std::vector<BYTE> expected (dst_bytes), converted (dst_bytes);
+        auto source = static_cast<const BYTE*>(tiles[0]->data());
+        CONVERT_PIXELS_SCALAR(source, expected.data(), TILE_PIX_AREA, pair.initial, pair.desired);
+        if (pair.inPlace) {
+            memcpy(converted.data(), source, dst_bytes);
+            source = converted.data();
+        }
+        convert_pixel_format(PixelConvertInfo {
+            .source         = source,
+            .destination    = converted.data(),
+            .pixels         = TILE_PIX_AREA,
+            .initial        = pair.initial,
+            .desired        = pair.desired,
+        });
+        if (expected != converted) throw std::runtime_error
+            (std::string("convert_pixel_format disagrees with the scalar loop for ") + pair.name);
+        
+        // In place conversions swap a per thread copy back and forth;
+        // the others convert the shared tiles into a per thread destination.
+        auto RUN = [&](bool vectorized) {
+            return RUN_PARALLEL(options.threads, count, [&](size_t index) {
+                thread_local std::vector<BYTE> scratch;
+                scratch.resize(TILE_PIX_AREA * 4);
+                const BYTE* src = static_cast<const BYTE*>(tiles[index % tiles.size()]->data());
+                BYTE*       dst = scratch.data();
+                if (pair.inPlace) src = dst;
+                if (vectorized) convert_pixel_format(PixelConvertInfo {
+                    .source         = src,
+                    .destination    = dst,
+                    .pixels         = TILE_PIX_AREA,
+                    .initial        = pair.initial,
+                    .desired        = pair.desired,
+                });
+                else CONVERT_PIXELS_SCALAR(src, dst, TILE_PIX_AREA, pair.initial, pair.desired);
+            });
+        };
+        const double scalar     = RUN(false);
+        const double vectorized = RUN(true);
+        REPORT_RATE(std::string(pair.name) + ", scalar loop",          megapixels, scalar,     "Mpx/s");
+        REPORT_RATE(std::string(pair.name) + ", convert_pixel_format", megapixels, vectorized, "Mpx/s",
+                    megapixels / scalar);
+    }
+}
+// MARK: - ENCODER WRITE BACKENDS
+#if IRIS_BENCH_ENCODER
+inline const char* WRITE_BACKEND_NAME (FileWriteBackend backend)
+{
+    switch (backend) {
+        case FILE_WRITE_MAPPED:      return "mapped";
+        case FILE_WRITE_POSITIONAL:  return "pwrite";
+        case FILE_WRITE_DIRECT:      return "direct";
+    }   return "unknown";
+}
+/// Encode the source into the directory and print the same throughput line
+/// the encoder executable prints. The output is removed afterwards so that
+/// every run writes a new file rather than resuming or replacing one.
+inline bool ENCODE_WITH_BACKEND (const BenchOptions& options, const std::string& outdir,
+                                 FileWriteBackend backend, bool report)
+{
+    EncodeSlideInfo info;
+    info.srcFilePath    = options.source;
+    info.dstFilePath    = outdir;
+    info.concurrency    = static_cast<unsigned>(options.threads);
+    info.context        = create_context();
+    auto encoder = create_encoder(info);
+    if (!encoder) throw std::runtime_error("Failed to create a slide encoder");
+    auto result = set_encoder_write_backend(encoder, backend);
+    if (result != Iris::IRIS_SUCCESS) {
+        std::cout << "  " << WRITE_BACKEND_NAME(backend) << ": " << result.message << "\n";
+        return false;
+    }
+    
+    const auto start = Clock::now();
+    result = dispatch_encoder(encoder);
+    if (result != Iris::IRIS_SUCCESS) throw std::runtime_error
+        ("Encoder reported failure to begin encoding: " + result.message);
+    EncoderProgress progress;
+    do {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        result = get_encoder_progress(encoder, progress);
+        if (result != Iris::IRIS_SUCCESS) throw std::runtime_error
+            ("Error during progress check: " + result.message);
+    } while (progress.status == ENCODER_ACTIVE);
+    const std::chrono::duration<double> elapsed = Clock::now() - start;
+    
+    std::string dst_dir;
+    get_encoder_dst_path(encoder, dst_dir);
+    const auto dst_file = std::filesystem::path(dst_dir) /
+        (std::filesystem::path(options.source).stem().string() + ".iris");
+    bool encoded = progress.status != ENCODER_ERROR;
+    if (!encoded)
+        std::cout << "  " << WRITE_BACKEND_NAME(backend) << ": " << progress.errorMsg << "\n";
+    else if (report) {
+        std::error_code size_error;
+        const auto written = std::filesystem::file_size(dst_file, size_error);
+        if (!size_error)
+            std::cout   << "  Wrote " << std::fixed << std::setprecision(1)
+                        << written / 1E6 << " MB in " << elapsed.count() << " s ("
+                        << written / 1E6 / std::max(elapsed.count(), 1E-3)
+                        << " MB/s) with the " << WRITE_BACKEND_NAME(backend)
+                        << " write backend\n" << std::defaultfloat;
+    }
+    std::error_code remove_error;
+    std::filesystem::remove(dst_file, remove_error);
+    return encoded;
+}
+inline void BENCH_WRITE (const BenchOptions& options)
+{
+    if (options.source.empty() || options.outdirs.empty()) throw std::runtime_error
+        ("the write benchmark requires a source (-s) and at least one output directory (-o)");
+    
+    // One untimed encode brings the source into the page cache so that
+    // the first measured backend does not also pay for the cold reads.
+    std::cout << "Warming the source " << options.source << " with an untimed encode\n";
+    ENCODE_WITH_BACKEND(options, options.outdirs.front(), FILE_WRITE_MAPPED, false);
+    for (auto& outdir : options.outdirs) {
+        std::cout << "Encoding into " << outdir << "\n";
+        for (auto backend : {FILE_WRITE_MAPPED, FILE_WRITE_POSITIONAL, FILE_WRITE_DIRECT})
+            ENCODE_WITH_BACKEND(options, outdir, backend, true);
+    }
+}
+#else
+inline void BENCH_WRITE (const BenchOptions&)
+{
+    throw std::runtime_error("the write benchmark requires building with IRIS_BUILD_ENCODER");
+}
+#endif // IRIS_BENCH_ENCODER
+// MARK: - ARGUMENT PARSING
+inline bool PARSE_COUNT (const char* arg, size_t& value)
+{
+    try {value = std::stoul(arg);}
+    catch (...) {return false;}
+    return value > 0;
+}
+int main(int argc, char const *argv[])
+{
+    if (argc < 2 || !strcmp(argv[1], "-h") || !strcmp(argv[1], "--help")) {
+        std::cout << help_statement;
+        return argc < 2 ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+    const std::string benchmark = argv[1];
+    BenchOptions options;
+    for (auto argi = 2; argi < argc; ++argi) {
+        const char* arg = argv[argi];
+        if (!strcmp(arg, "-s") || !strcmp(arg, "--source") ||
+            !strcmp(arg, "-o") || !strcmp(arg, "--outdir")) {
+            if (argi+1 >= argc) {
+                std::cerr << "Argument \"" << arg << "\" requires a path\n";
+                return EXIT_FAILURE;
+            }
+            if (arg[1] == 's' || arg[2] == 's') options.source = argv[++argi];
+            else options.outdirs.push_back(argv[++argi]);
+            continue;
+        }
+        size_t* value   = NULL;
+        if (!strcmp(arg, "-t") || !strcmp(arg, "--threads"))     value = &options.threads;
+        else if (!strcmp(arg, "-n") || !strcmp(arg, "--tiles"))  value = &options.tiles;
+        else if (!strcmp(arg, "-p") || !strcmp(arg, "--passes")) value = &options.passes;
+        if (value == NULL || argi+1 >= argc || !PARSE_COUNT(argv[++argi], *value)) {
+            std::cerr << "Invalid argument \"" << arg << "\"\n" << help_statement;
+            return EXIT_FAILURE;
+        }
+    }
+    try {
+        if (benchmark == "jpeg") BENCH_JPEG(options);
+        else if (benchmark == "convert") BENCH_CONVERT(options);
+        else if (benchmark == "write") BENCH_WRITE(options);
+        else {
+            std::cerr << "Unknown benchmark \"" << benchmark << "\"\n" << help_statement;
+            return EXIT_FAILURE;
+        }
+    } catch (std::runtime_error& error) {
+        std::cerr << "Benchmark failed: " << error.what() << "\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
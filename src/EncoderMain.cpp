@@ -25,9 +25,10 @@
 #include <iomanip>
 #include <filesystem>
 #include <set>
+#include <csignal>
 #include <iomanip>   // for std::setfill, std::setw
 
-#include "IrisCodecCore.hpp"
+#include "IrisCodecPriv.hpp"
 constexpr char help_statement[] = 
 "Iris Codec Encoder allows for the encoding of whole slide image \
 (WSI) files into the Iris Codec file extension format (.iris)\n \
@@ -41,8 +42,18 @@ represents the previous file name (ex /path/to/slide.svs will be named /outdir/s
 -sm --strip_metadata: Strip patient identifiers from the encoded metadata within the slide file \
 -e --encoding: JPEG or AVIF (default JPEG)\
 -c --concurrency: How many threads should this run on (defaults to all cores for fastest encoding)\
+-q --quality: Tile compression quality from 0 to 100 (default 90)\
+-ss --subsampling: Chroma subsampling of 444, 422, or 420 (default 422)\
+-oh --optimize_huffman: Generate optimal JPEG Huffman tables per tile (smaller files, slower encoding)\
+-as --avif_speed: AVIF encoder speed from 0 (slowest, smallest) to 10 (fastest, default)\
+-dd --deduplicate: Store byte-identical compressed tiles only once\
+-wb --write_backend: How tiles are written to file: mapped (default), pwrite, or direct (pwrite bypassing the page cache)\
+-cp --checkpoint: Journal the encoded tiles every N seconds so an interrupted encode resumes when rerun with the same source and output\
 \n";
 const std::u8string complt_char = u8"█";
+// Set on SIGINT / SIGTERM (ex. node preemption) to interrupt a checkpointed encode
+volatile std::sig_atomic_t interrupt_signal = 0;
+extern "C" void ON_INTERRUPT_SIGNAL (int) { interrupt_signal = 1; }
 enum ArgumentFlag : uint32_t {
     ARG_HELP    = 0,
     ARG_SOURCE,
@@ -51,6 +62,13 @@ enum ArgumentFlag : uint32_t {
     ARG_STRIP_METADATA,
     ARG_ENCODING,
     ARG_CONCURRENCY,
+    ARG_QUALITY,
+    ARG_SUBSAMPLING,
+    ARG_OPTIMIZE_HUFFMAN,
+    ARG_AVIF_SPEED,
+    ARG_DEDUPLICATE,
+    ARG_WRITE_BACKEND,
+    ARG_CHECKPOINT,
     ARG_INVALID = UINT32_MAX
 };
 inline ArgumentFlag PARSE_ARGUMENT (const char* arg_str) {
@@ -68,6 +86,20 @@ inline ArgumentFlag PARSE_ARGUMENT (const char* arg_str) {
         return ARG_ENCODING;
     if (!strcmp(arg_str, "-c") || !strcmp(arg_str, "--concurrency"))
         return ARG_CONCURRENCY;
+    if (!strcmp(arg_str, "-q") || !strcmp(arg_str, "--quality"))
+        return ARG_QUALITY;
+    if (!strcmp(arg_str, "-ss") || !strcmp(arg_str, "--subsampling"))
+        return ARG_SUBSAMPLING;
+    if (!strcmp(arg_str, "-oh") || !strcmp(arg_str, "--optimize_huffman"))
+        return ARG_OPTIMIZE_HUFFMAN;
+    if (!strcmp(arg_str, "-as") || !strcmp(arg_str, "--avif_speed"))
+        return ARG_AVIF_SPEED;
+    if (!strcmp(arg_str, "-dd") || !strcmp(arg_str, "--deduplicate"))
+        return ARG_DEDUPLICATE;
+    if (!strcmp(arg_str, "-wb") || !strcmp(arg_str, "--write_backend"))
+        return ARG_WRITE_BACKEND;
+    if (!strcmp(arg_str, "-cp") || !strcmp(arg_str, "--checkpoint"))
+        return ARG_CHECKPOINT;
     return ARG_INVALID;
 }
 inline IrisCodec::Encoding PARSE_ENCODING (std::string arg)
@@ -79,6 +111,36 @@ inline IrisCodec::Encoding PARSE_ENCODING (std::string arg)
         return IrisCodec::TILE_ENCODING_AVIF;
     return IrisCodec::TILE_ENCODING_UNDEFINED;
 }
+inline bool PARSE_SUBSAMPLING (const std::string& arg, IrisCodec::Subsampling& subsampling)
+{
+    if (arg == "444" || arg == "4:4:4") subsampling = IrisCodec::SUBSAMPLE_444;
+    else if (arg == "422" || arg == "4:2:2") subsampling = IrisCodec::SUBSAMPLE_422;
+    else if (arg == "420" || arg == "4:2:0") subsampling = IrisCodec::SUBSAMPLE_420;
+    else return false;
+    return true;
+}
+inline bool PARSE_BOUNDED_INT (const std::string& arg, int min, int max, int& value)
+{
+    try {value = std::stoi(arg);}
+    catch (...) {return false;}
+    return value >= min && value <= max;
+}
+inline bool PARSE_WRITE_BACKEND (const std::string& arg, IrisCodec::FileWriteBackend& backend)
+{
+    if (arg == "mapped") backend = IrisCodec::FILE_WRITE_MAPPED;
+    else if (arg == "pwrite") backend = IrisCodec::FILE_WRITE_POSITIONAL;
+    else if (arg == "direct") backend = IrisCodec::FILE_WRITE_DIRECT;
+    else return false;
+    return true;
+}
+inline const char* WRITE_BACKEND_NAME (IrisCodec::FileWriteBackend backend)
+{
+    switch (backend) {
+        case IrisCodec::FILE_WRITE_MAPPED:      return "mapped";
+        case IrisCodec::FILE_WRITE_POSITIONAL:  return "pwrite";
+        case IrisCodec::FILE_WRITE_DIRECT:      return "direct";
+    }   return "unknown";
+}
 inline IrisCodec::EncoderDerivation::Layers PARSE_DERIVATION (std::string arg)
 {
     for (auto& c : arg) tolower(c);
@@ -95,6 +157,12 @@ int main(int argc, char const *argv[])
     IrisCodec::EncodeSlideInfo info;
     IrisCodec::EncoderDerivation derivation;
     bool strip_metadata     = false;
+    auto write_backend      = IrisCodec::FILE_WRITE_MAPPED;
+    IrisCodec::EncoderCheckpointOptions checkpoints;
+    // Tile compression parameters are carried by the encoder's codec context
+    auto context            = IrisCodec::create_context();
+    auto avif_options       = context->get_avif_options();
+    info.context            = context;
     info.desiredEncoding    = IrisCodec::TILE_ENCODING_DEFAULT;
     if (argc < 2) {
         std::cerr << help_statement;
@@ -164,6 +232,47 @@ int main(int argc, char const *argv[])
                     << "bad idea; the system works best when at the number of cores (which is the default)."
                     << "If you want the greatest speed, do not define -c/--concurrency, or use it to lower performance.";
             } break;
+            case ARG_QUALITY: {
+                int quality = 0;
+                if (argi+1>=argc || !PARSE_BOUNDED_INT(argv[++argi], 0, 100, quality)) {
+                    std::cerr<<"quality argument requires a value from 0 to 100\n";
+                    return EXIT_FAILURE;
+                } context->set_quality(static_cast<IrisCodec::Quality>(quality));
+            } break;
+            case ARG_SUBSAMPLING: {
+                IrisCodec::Subsampling subsampling;
+                if (argi+1>=argc || !PARSE_SUBSAMPLING(argv[++argi], subsampling)) {
+                    std::cerr<<"subsampling argument requires 444, 422, or 420\n";
+                    return EXIT_FAILURE;
+                } context->set_subsampling(subsampling);
+            } break;
+            case ARG_OPTIMIZE_HUFFMAN:
+                context->set_jpeg_optimize(true);
+                break;
+            case ARG_AVIF_SPEED:
+                if (argi+1>=argc || !PARSE_BOUNDED_INT(argv[++argi], 0, 10, avif_options.speed)) {
+                    std::cerr<<"avif speed argument requires a value from 0 to 10\n";
+                    return EXIT_FAILURE;
+                } context->set_avif_options(avif_options);
+                break;
+            case ARG_DEDUPLICATE:
+                context->set_tile_deduplication(true);
+                break;
+            case ARG_WRITE_BACKEND:
+                if (argi+1>=argc || !PARSE_WRITE_BACKEND(argv[++argi], write_backend)) {
+                    std::cerr<<"write backend argument requires mapped, pwrite, or direct\n";
+                    return EXIT_FAILURE;
+                }
+                break;
+            case ARG_CHECKPOINT: {
+                int interval = 0;
+                if (argi+1>=argc || !PARSE_BOUNDED_INT(argv[++argi], 1, 86400, interval)) {
+                    std::cerr<<"checkpoint argument requires an interval from 1 to 86400 seconds\n";
+                    return EXIT_FAILURE;
+                }
+                checkpoints.enabled     = true;
+                checkpoints.interval    = static_cast<uint32_t>(interval);
+            } break;
             case ARG_INVALID:
                 std::cerr   << "Unknown argument \""
                             << argv[argi]
@@ -192,9 +301,14 @@ int main(int argc, char const *argv[])
         std::cerr   << "Failed to create a slide encoder. The system will exit.";
         return EXIT_FAILURE;
     }
+    if (write_backend != IrisCodec::FILE_WRITE_MAPPED)
+        IrisCodec::set_encoder_write_backend(encoder, write_backend);
+    if (checkpoints.enabled)
+        IrisCodec::set_encoder_checkpoints(encoder, checkpoints);
     
     // Dispatch the encoder. This will return immediately after
     // initializing the encoding process on multiple asynchronous threads
+    const auto encode_start = std::chrono::steady_clock::now();
     auto result = IrisCodec::dispatch_encoder(encoder);
     if (result != Iris::IRIS_SUCCESS) {
         std::cerr   << "Encoder reported failure to begin encoding: "
@@ -210,7 +324,14 @@ int main(int argc, char const *argv[])
     std::cout << "Encoding slide file: " << progress.dstFilePath << "\n";
     float cmplt = 0.001f;
     auto  start = std::chrono::system_clock::now();
+    // Checkpointed encodes are interrupted (and journaled) on a signal
+    // rather than killed, so that rerunning them resumes the encode
+    if (checkpoints.enabled) {
+        std::signal(SIGINT,  ON_INTERRUPT_SIGNAL);
+        std::signal(SIGTERM, ON_INTERRUPT_SIGNAL);
+    }
     while (progress.status == IrisCodec::ENCODER_ACTIVE) {
+        if (interrupt_signal) IrisCodec::interrupt_encoder(encoder);
         
         // Check on the current encoder progress
         result = IrisCodec::get_encoder_progress(encoder, progress);
@@ -256,6 +377,30 @@ int main(int argc, char const *argv[])
                     << progress.errorMsg;
     } else {
         std::cout << "\nIris Encoder completed successfully\n";
+        
+        // Report the encode throughput so that write backends and output
+        // file systems (ex. tmpfs against disk) may be compared directly
+        const std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - encode_start;
+        std::string dst_dir;
+        IrisCodec::get_encoder_dst_path(encoder, dst_dir);
+        const auto dst_file = std::filesystem::path(dst_dir) /
+            (std::filesystem::path(info.srcFilePath).stem().string() + ".iris");
+        std::error_code size_error;
+        const auto written  = std::filesystem::file_size(dst_file, size_error);
+        if (!size_error)
+            std::cout   << "Wrote " << std::fixed << std::setprecision(1)
+                        << written / 1E6 << " MB in " << elapsed.count() << " s ("
+                        << written / 1E6 / std::max(elapsed.count(), 1E-3)
+                        << " MB/s) with the " << WRITE_BACKEND_NAME(write_backend)
+                        << " write backend\n" << std::defaultfloat;
+        IrisCodec::EncoderDedupStats dedup;
+        if (IrisCodec::get_encoder_dedup_stats(encoder, dedup) == Iris::IRIS_SUCCESS &&
+            dedup.tilesShared)
+            std::cout   << dedup.tilesShared << " of " << dedup.tilesWritten
+                        << " tiles (" << std::setprecision(3) << dedup.ratio*100.f
+                        << "%) reuse stored tile data, saving "
+                        << dedup.bytesSaved / 1000000 << " MB\n";
         return EXIT_SUCCESS;
     }
     
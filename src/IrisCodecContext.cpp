@@ -5,6 +5,7 @@
 //  Created by Ryan Landvater on 1/9/24.
 //
 #include <sstream>
+#include <algorithm>
 #include "IrisCodecPriv.hpp"
 #include "IrisCoreVulkan.hpp"
 #include <png.h>
@@ -153,10 +154,25 @@ inline avifRGBFormat CONVERT_TO_AVIF_RGBFORMAT (Format format)
     std::cerr << "Invalid format provided, returning AVIF_RGB_FORMAT_COUNT";
     return AVIF_RGB_FORMAT_COUNT;
 }
-//static Buffer CPU_SIMD_CONVERT_FORMAT (const Buffer& src, Format s_format, Format d_format)
-//{
-//
-//}
+/// Convert a decoded image in place from the layout a codec emitted into the
+/// requested layout. Codecs that emit the requested layout natively (TurboJPEG
+/// and libavif) never reach this; it is a no-op when the formats match.
+inline void CONVERT_FORMAT (const Buffer& pixels,
+                            Format initial,
+                            Format desired,
+                            size_t pixel_count)
+{
+    if (initial == desired) return;
+    auto data = static_cast<BYTE*>(pixels->data());
+    convert_pixel_format({
+        .source         = data,
+        .destination    = data,
+        .pixels         = pixel_count,
+        .initial        = initial,
+        .desired        = desired,
+    });
+    pixels->set_size(pixel_count * BITS_PER_PIXEL(desired));
+}
 inline void SIMPLY_COPY (const Buffer& src, Buffer& dst)
 {
     memcpy(dst->append(src->size()), src->data(), src->size());
@@ -318,10 +334,18 @@ inline Buffer DECOMPRESS_PNG (const Buffer &src,
                 break;
         } if (bpp == 0) throw std::runtime_error
             ("Failed to calculate destination buffer size. Invalid pixel format provided");
-
-        // Create the output image buffer
-        if (!dst_buffer || bpp*pixel_extent > dst_buffer->size())
-            dst_buffer = Create_strong_buffer(bpp*pixel_extent);
+        if (desiredFormat == Iris::FORMAT_UNDEFINED)
+            desiredFormat       = sourceFormat;
+        
+        // Create the output image buffer. The image is decoded in its stored
+        // format and converted in place, so the buffer must fit the wider of the two.
+        size_t dst_bpp          = BITS_PER_PIXEL(desiredFormat);
+        if (dst_bpp == 0) throw std::runtime_error
+            ("Failed to calculate destination buffer size. Invalid desired pixel format");
+        size_t dst_extent       = std::max(bpp, dst_bpp) * pixel_extent;
+        if (!dst_buffer || dst_extent > dst_buffer->capacity())
+            dst_buffer = Create_strong_buffer(dst_extent);
+        dst_buffer->set_size(bpp*pixel_extent);
         
         std::vector<png_bytep>row_ptrs(height);
         for (auto row = 0, offset = 0; row < height; ++row, offset+=(width*bpp))
@@ -348,13 +372,8 @@ inline Buffer DECOMPRESS_PNG (const Buffer &src,
         png_read_png(__png_decoder, __png_info, PNG_TRANSFORM_IDENTITY, NULL);
         png_destroy_read_struct(&__png_decoder, &__png_info, &__end_info);
         
-        // TODO: Enable SIMD extension to convert format once stable
-        int enable_convert_format = 0; // Cause compiler warning.
-//        dst_buffer = Iris::SIMD::convert_format ({
-//            .source     = dst_buffer,
-//            .initial    = sourceFormat,
-//            .desired    = desiredFormat,
-//        });
+        // PNG has no BGR layouts; swap and pad / strip alpha as requested
+        CONVERT_FORMAT(dst_buffer, sourceFormat, desiredFormat, pixel_extent);
         
     } catch (std::runtime_error &e) {
         if (__png_decoder)
@@ -365,20 +384,53 @@ inline Buffer DECOMPRESS_PNG (const Buffer &src,
         throw std::runtime_error(log.str());
     }   return dst_buffer; // Place after try-catch to satisfy MSVC
 }
-inline Buffer COMPRESS_JPEG (const Buffer &src,
+/// Scoped loan of a codec handle from a context handle pool.
+/// The handle is returned to the pool when the loan leaves scope.
+struct PooledHandle {
+    const __INTERNAL__HandlePool&   pool;
+    void* const                     handle;
+    explicit PooledHandle           (const __INTERNAL__HandlePool& __p) :
+    pool                            (__p),
+    handle                          (__p.acquire()) {}
+    PooledHandle                    (const PooledHandle&) = delete;
+    PooledHandle operator =         (const PooledHandle&) = delete;
+   ~PooledHandle                    () { pool.release(handle); }
+};
+static void* CREATE_JPEG_COMPRESSOR ()
+{
+    tjhandle turbo_handle = tj3Init (TJINIT_COMPRESS);
+    // Destination buffers are always sized with tjBufSize; TurboJPEG must
+    // never attempt to reallocate (and thereby free) an Iris buffer.
+    if (turbo_handle) tj3Set(turbo_handle, TJPARAM_NOREALLOC, 1);
+    return turbo_handle;
+}
+static void* CREATE_JPEG_DECOMPRESSOR ()
+{
+    return tj3Init (TJINIT_DECOMPRESS);
+}
+static void DESTROY_JPEG_HANDLE (void* turbo_handle)
+{
+    tj3Destroy (static_cast<tjhandle>(turbo_handle));
+}
+inline Buffer COMPRESS_JPEG (const __INTERNAL__HandlePool& pool,
+                             const Buffer &src,
+                             Buffer dst_buffer,
                              Format format,
                              Quality quality,
                              Subsampling subsampling,
                              uint32_t width,
-                             uint32_t height)
+                             uint32_t height,
+                             bool optimize = false)
 {
-    tjhandle turbo_handle = NULL;
-    auto dst = Create_strong_buffer(tjBufSize(width, height,
-                                              CONVERT_TO_TJSAMP(subsampling)));
+    // Compress into the caller's buffer when it can hold the worst case
+    const size_t bound = tjBufSize(width, height, CONVERT_TO_TJSAMP(subsampling));
+    auto dst = dst_buffer && dst_buffer->capacity() >= bound ?
+               dst_buffer : Create_strong_buffer(bound);
     try {
+        PooledHandle loan (pool);
+        tjhandle turbo_handle = loan.handle;
         size_t size     = dst->capacity();
         auto dst_ptr    = (BYTE*)dst->data();
-        turbo_handle    = tj3Init (TJINIT_COMPRESS);
         if (turbo_handle == NULL)
             throw std::runtime_error("Failed to create a TURBO_JPEG Context");
         // Set the desired image quality
@@ -389,24 +441,23 @@ inline Buffer COMPRESS_JPEG (const Buffer &src,
         if (tj3Set(turbo_handle, TJPARAM_SUBSAMP, CONVERT_TO_TJSAMP(subsampling)))
             throw std::runtime_error("Failed to configure TURBO_JPEG Context -- " +
                                      std::string(tj3GetErrorStr(turbo_handle)));
-        // Compress the image
+        // Set (or clear; handles are pooled) Huffman table optimization
+        if (tj3Set(turbo_handle, TJPARAM_OPTIMIZE, optimize ? 1 : 0))
+            throw std::runtime_error("Failed to configure TURBO_JPEG Context -- " +
+                                     std::string(tj3GetErrorStr(turbo_handle)));
+        // Compress the image (the pooled compressors never reallocate the
+        // destination; see CREATE_JPEG_COMPRESSOR)
         if (tj3Compress8(turbo_handle, static_cast<BYTE*>(src->data()),
                          width, 0, height,
                          CONVERT_TO_TJPIXEL_FORMAT(format),
                          &dst_ptr, &size))
             throw std::runtime_error("TURBO_JPEG failed to compress tile data --" +
                                      std::string(tj3GetErrorStr(turbo_handle)));
-        tj3Destroy  (turbo_handle);
         
-        // If JPEG_TURBO reallocated the pointer, copy the data out of the new pointer
-        // and return that instead. This should never happen...
-        if (dst_ptr != dst->data())
-            dst = Copy_strong_buffer_from_data(dst_ptr, size);
         // Make sure to update the size of the buffer and return.
-        else dst->set_size(size);
+        dst->set_size(size);
         return dst;
     } catch (std::runtime_error &e) {
-        if (turbo_handle) tjDestroy(turbo_handle);
         std::stringstream log;
         log << "Failed to compress JPEG tile: "
             << e.what() << "\n";
@@ -414,38 +465,90 @@ inline Buffer COMPRESS_JPEG (const Buffer &src,
         return Buffer();
     }   return Buffer();
 }
-inline Buffer DECOMPRESS_JPEG (const Buffer &compressed,
+inline size_t DECOMPRESSED_EXTENT (uint32_t width,
+                                   uint32_t height,
+                                   Format format,
+                                   size_t dst_offset,
+                                   size_t row_pitch)
+{
+    // Number of bytes of the destination touched by a decode, from its start
+    const size_t row_bytes = width * BITS_PER_PIXEL(format);
+    if (!row_bytes || !height) return 0;
+    if (row_pitch && row_pitch < row_bytes) throw std::runtime_error
+        ("Destination row pitch is narrower than a decoded row");
+    return dst_offset + (height-1) * (row_pitch ? row_pitch : row_bytes) + row_bytes;
+}
+inline Buffer DECOMPRESS_DESTINATION (Buffer dst_buffer,
+                                      size_t buffer_size,
+                                      bool pitched)
+{
+    if (dst_buffer && buffer_size <= dst_buffer->capacity())
+        return dst_buffer;
+    // A pitched write targets a specific location within a caller image;
+    // a replacement allocation would silently discard the decoded pixels.
+    if (pitched) throw std::runtime_error
+        ("Destination buffer is too small for the requested offset and row pitch");
+    return Create_strong_buffer(buffer_size);
+}
+inline Buffer DECOMPRESS_JPEG (const __INTERNAL__HandlePool& pool,
+                               const Buffer &compressed,
                                Buffer dst_buffer,
                                Format desired_format,
                                uint32_t width,
-                               uint32_t height)
+                               uint32_t height,
+                               size_t dst_offset = 0,
+                               size_t row_pitch = 0,
+                               DecodeScale scale = DECODE_SCALE_FULL)
 {
     auto&       src_buffer  = compressed;
     TJPF        format      = CONVERT_TO_TJPIXEL_FORMAT(desired_format);
-    tjhandle    tjhandle    = NULL;
-    size_t      buffer_size = width*height*BITS_PER_PIXEL(desired_format);
+    const tjscalingfactor scaling {1, static_cast<int>(scale)};
+    size_t      buffer_size = DECOMPRESSED_EXTENT(TJSCALED(width, scaling),
+                                                  TJSCALED(height, scaling),
+                                                  desired_format,
+                                                  dst_offset, row_pitch);
+    const bool  pitched     = dst_offset || row_pitch;
 
     if (format == TJPF_UNKNOWN || !buffer_size) throw std::runtime_error
         ("DECOMPRESS_JPEG failed due to undefined destination pixel format");
     
-    if (!dst_buffer || buffer_size > dst_buffer->capacity())
-        dst_buffer = Create_strong_buffer(buffer_size);
+    dst_buffer = DECOMPRESS_DESTINATION(dst_buffer, buffer_size, pitched);
     
     try {
-        tjhandle = tj3Init(TJINIT_DECOMPRESS);
-        tj3Set(tjhandle, TJPARAM_JPEGWIDTH,  width);
-        tj3Set(tjhandle, TJPARAM_JPEGHEIGHT, height);
+        PooledHandle loan (pool);
+        tjhandle tjhandle = loan.handle;
+        if (tjhandle == NULL) throw std::runtime_error
+            ("Failed to create a TURBO_JPEG Context");
+        // Always set the scaling factor: pooled handles retain the
+        // factor of whichever decode last used them.
+        if (tj3SetScalingFactor(tjhandle, scaling)) throw std::runtime_error
+            ("Failed to set TURBO_JPEG scaling factor -- " +
+             std::string(tj3GetErrorStr(tjhandle)));
+        // The destination is sized for the expected tile; a corrupt or
+        // foreign stream of other dimensions would overrun it.
+        if (tj3DecompressHeader(tjhandle, static_cast<const BYTE*>(src_buffer->data()),
+                                src_buffer->size())) throw std::runtime_error
+            ("DECOMPRESS_JPEG failed to read the JPEG header -- " +
+             std::string(tj3GetErrorStr(tjhandle)));
+        const int jpeg_width  = tj3Get(tjhandle, TJPARAM_JPEGWIDTH);
+        const int jpeg_height = tj3Get(tjhandle, TJPARAM_JPEGHEIGHT);
+        if (jpeg_width != static_cast<int>(width) || jpeg_height != static_cast<int>(height))
+            throw std::runtime_error
+            ("DECOMPRESS_JPEG stream is " + std::to_string(jpeg_width) + "x" +
+             std::to_string(jpeg_height) + " rather than the expected " +
+             std::to_string(width) + "x" + std::to_string(height));
         int result = tj3Decompress8
         (tjhandle, static_cast<const BYTE*>(src_buffer->data()),
          src_buffer->size(),
-         static_cast<BYTE*>(dst_buffer->data()),
-         0, format);
+         static_cast<BYTE*>(dst_buffer->data()) + dst_offset,
+         static_cast<int>(row_pitch), format);
         
         if (result) throw std::runtime_error
             ("DECOMPRESS_JPEG failed with tj3error " +
              std::string(tj3GetErrorStr(tjhandle)));
         
-        dst_buffer->set_size(buffer_size);
+        // A pitched destination is sized by its owner
+        if (!pitched) dst_buffer->set_size(buffer_size);
         
     } catch (std::runtime_error& error) {
         std::cerr   << "Failed to decompress JPEG tile: "
@@ -453,10 +556,39 @@ inline Buffer DECOMPRESS_JPEG (const Buffer &compressed,
         dst_buffer  = NULL;
     }
     
-    if (tjhandle) tj3Destroy (tjhandle);
     return dst_buffer;
 }
-inline Buffer COMPRESS_AVIF_CPU (const Buffer &src_buffer,
+static void* CREATE_AVIF_DECODER ()
+{
+    return avifDecoderCreate();
+}
+static void DESTROY_AVIF_DECODER (void* decoder)
+{
+    avifDecoderDestroy (static_cast<avifDecoder*>(decoder));
+}
+struct AVIF_IMAGE_DELETER {
+    void operator () (avifImage* image) const { avifImageDestroy(image); }
+};
+/// Per-thread YUV staging image for AVIF compression. Its planes are kept
+/// allocated between tiles and are only recreated when the image geometry,
+/// bit depth or chroma subsampling of the next encode differs.
+inline avifImage* AVIF_STAGING_IMAGE (uint32_t width,
+                                      uint32_t height,
+                                      uint32_t depth,
+                                      avifPixelFormat yuv_format)
+{
+    thread_local std::unique_ptr<avifImage, AVIF_IMAGE_DELETER> staging;
+    if (!staging ||
+        staging->width      != width  ||
+        staging->height     != height ||
+        staging->depth      != depth  ||
+        staging->yuvFormat  != yuv_format)
+        staging.reset(avifImageCreate(width, height, depth, yuv_format));
+    return staging.get();
+}
+inline Buffer COMPRESS_AVIF_CPU (const AvifCodecOptions& options,
+                                 const Buffer &src_buffer,
+                                 Buffer dst_optional,
                                  Format format,
                                  Quality quality,
                                  Subsampling subsampling,
@@ -464,13 +596,12 @@ inline Buffer COMPRESS_AVIF_CPU (const Buffer &src_buffer,
                                  uint32_t height)
 {
     Buffer          dst_buffer  = nullptr;
-    avifImage*      image       = nullptr;
     avifEncoder*    encoder     = NULL;
     avifRWData      avifOutput  = AVIF_DATA_EMPTY;
     avifRGBImage    rgb         = AVIF_RGB_BLANK_IMAGE;
     
     try {
-        image                   = avifImageCreate
+        avifImage* image        = AVIF_STAGING_IMAGE
         (width, height,
          BIT_DEPTH(format),
          CONVERT_TO_AVIF_SAMP(subsampling));
@@ -481,7 +612,7 @@ inline Buffer COMPRESS_AVIF_CPU (const Buffer &src_buffer,
         avifRGBImageSetDefaults(&rgb, image);
         rgb.ignoreAlpha = true;
         rgb.format      = CONVERT_TO_AVIF_RGBFORMAT(format);
-        rgb.maxThreads  = 1;
+        rgb.maxThreads  = options.threads;
         rgb.pixels      = (uint8_t*)src_buffer->data();
         rgb.rowBytes    = width * BITS_PER_PIXEL(format);
         
@@ -490,12 +621,16 @@ inline Buffer COMPRESS_AVIF_CPU (const Buffer &src_buffer,
             ("failed to convert to RGB image YUV -- "+
              std::string(avifResultToString(result)));
         
+        // An avifEncoder retains the sequence state of every image it is
+        // given and cannot begin a new single-image stream once finished,
+        // so unlike the decoders it is not pooled.
         encoder = avifEncoderCreate();
         if (encoder == NULL) throw std::runtime_error
             ("Failed to create AVIF encoder");
-        encoder->maxThreads = 1;
+        encoder->maxThreads = options.threads;
         encoder->quality    = (int)quality;
-        encoder->speed      = 10;
+        encoder->speed      = options.speed;
+        encoder->autoTiling = options.autoTiling ? AVIF_TRUE : AVIF_FALSE;
         
         result = avifEncoderAddImage(encoder, image, 1, AVIF_ADD_IMAGE_FLAG_SINGLE);
         if (result != AVIF_RESULT_OK) throw std::runtime_error
@@ -509,10 +644,19 @@ inline Buffer COMPRESS_AVIF_CPU (const Buffer &src_buffer,
              std::string(avifResultToString(result)));
         
         
-        // Transfer control of the data to an Iris buffer
-        dst_buffer = Wrap_weak_buffer_fom_data(avifOutput.data, avifOutput.size);
-        dst_buffer->change_strength(REFERENCE_STRONG);
-        avifOutput = AVIF_DATA_EMPTY;
+        // Copy into the caller's buffer if it fits; libavif allocates its
+        // own output (and the encoder) for every tile regardless, so this
+        // path is not allocation free. Otherwise transfer control of the
+        // data to an Iris buffer.
+        if (dst_optional && dst_optional->capacity() >= avifOutput.size) {
+            dst_buffer = dst_optional;
+            dst_buffer->set_size(0);
+            memcpy(dst_buffer->append(avifOutput.size), avifOutput.data, avifOutput.size);
+        } else {
+            dst_buffer = Wrap_weak_buffer_fom_data(avifOutput.data, avifOutput.size);
+            dst_buffer->change_strength(REFERENCE_STRONG);
+            avifOutput = AVIF_DATA_EMPTY;
+        }
         
     } catch (std::runtime_error& error) {
         std::cerr   << "Failed to compress AVIF tile: "
@@ -520,40 +664,48 @@ inline Buffer COMPRESS_AVIF_CPU (const Buffer &src_buffer,
         dst_buffer = NULL;
     }
 
-    if (image)   avifImageDestroy   (image);
     if (encoder) avifEncoderDestroy (encoder);
     avifRWDataFree (&avifOutput);
     return dst_buffer;
 }
-inline Buffer DECOMPRESS_AVIF_CPU (const Buffer &compressed,
+inline Buffer DECOMPRESS_AVIF_CPU (const __INTERNAL__HandlePool& pool,
+                                   const AvifCodecOptions& options,
+                                   const Buffer &compressed,
                                    Buffer dst_buffer,
                                    Format desired_format,
                                    uint32_t width,
-                                   uint32_t height)
+                                   uint32_t height,
+                                   size_t dst_offset = 0,
+                                   size_t row_pitch = 0)
 {
     auto&           src_buffer  = compressed;
-    avifDecoder*    decoder     = NULL;
-    size_t          buffer_size = width*height*BITS_PER_PIXEL(desired_format);
+    size_t          buffer_size = DECOMPRESSED_EXTENT(width, height, desired_format,
+                                                      dst_offset, row_pitch);
+    const bool      pitched     = dst_offset || row_pitch;
     
     // Reallocate buffer if insufficient space provided
-    if (!dst_buffer || dst_buffer->size() < buffer_size)
-        dst_buffer = Create_strong_buffer (buffer_size);
+    dst_buffer = DECOMPRESS_DESTINATION(dst_buffer, buffer_size, pitched);
     
     try {
         avifRGBImage rgb    = AVIF_RGB_BLANK_IMAGE;
         rgb.format          = CONVERT_TO_AVIF_RGBFORMAT(desired_format);
-        rgb.rowBytes        = width * BITS_PER_PIXEL(desired_format);
+        rgb.rowBytes        = row_pitch ? row_pitch : width * BITS_PER_PIXEL(desired_format);
         rgb.depth           = BIT_DEPTH(desired_format);
-        rgb.pixels          = (uint8_t*)dst_buffer->data();
+        rgb.maxThreads      = options.threads;
+        rgb.pixels          = (uint8_t*)dst_buffer->data() + dst_offset;
         
         if (rgb.format == AVIF_RGB_FORMAT_COUNT || !buffer_size) throw std::runtime_error
             ("Failed due to undefined destination pixel format");
-
-        decoder = avifDecoderCreate();
+        
+        // Pooled decoders are reset by setting new IO. Their limits are
+        // always reapplied as the previous borrower may have decoded an
+        // image of a different size.
+        PooledHandle loan (pool);
+        auto decoder = static_cast<avifDecoder*>(loan.handle);
         if (decoder == NULL) throw std::runtime_error
-            ("Failed to create AVIF encoder");
-        decoder->maxThreads = 1;
-        decoder->imageDimensionLimit = TILE_PIX_LENGTH;
+            ("Failed to create AVIF decoder");
+        decoder->maxThreads = options.threads;
+        decoder->imageDimensionLimit = std::max(width, height);
         
         avifResult result = avifDecoderSetIOMemory
         (decoder, (uint8_t*)src_buffer->data(), src_buffer->size());
@@ -565,6 +717,11 @@ inline Buffer DECOMPRESS_AVIF_CPU (const Buffer &compressed,
         if (result != AVIF_RESULT_OK) throw std::runtime_error
             ("Failed to decode AVIF tile -- "+
              std::string(avifResultToString(result)));
+        if (decoder->image->width != width || decoder->image->height != height)
+            throw std::runtime_error
+            ("AVIF tile is " + std::to_string(decoder->image->width) + "x" +
+             std::to_string(decoder->image->height) + " rather than the expected " +
+             std::to_string(width) + "x" + std::to_string(height));
         
         result = avifDecoderNextImage(decoder);
         if (result != AVIF_RESULT_OK) throw std::runtime_error
@@ -576,22 +733,251 @@ inline Buffer DECOMPRESS_AVIF_CPU (const Buffer &compressed,
             ("Failed to convert YUV formatted tile -- "+
              std::string(avifResultToString(result)));
         
+        // A pitched destination is sized by its owner
+        if (!pitched) dst_buffer->set_size(buffer_size);
+        
     } catch (std::runtime_error& error) {
         std::cerr   << "DECOMPRESS_AVIF_CPU error: "
                     << error.what() << "\n";
         dst_buffer = NULL;
     }
-    if (decoder) avifDecoderDestroy(decoder);
     return dst_buffer;
 }
+inline Buffer DOWNSAMPLE_BOX (const Buffer& source,
+                              Buffer dst_buffer,
+                              Format format,
+                              uint32_t width,
+                              uint32_t height,
+                              DecodeScale scale,
+                              size_t dst_offset = 0,
+                              size_t row_pitch = 0)
+{
+    const uint32_t bpp          = BITS_PER_PIXEL(format);
+    const uint32_t dst_width    = width  / scale;
+    const uint32_t dst_height   = height / scale;
+    const size_t   buffer_size  = DECOMPRESSED_EXTENT(dst_width, dst_height, format,
+                                                      dst_offset, row_pitch);
+    const bool     pitched      = dst_offset || row_pitch;
+    if (!bpp || !buffer_size) throw std::runtime_error
+        ("DOWNSAMPLE_BOX failed due to undefined pixel format");
+    dst_buffer = DECOMPRESS_DESTINATION(dst_buffer, buffer_size, pitched);
+    
+    // Average each scale x scale block of source pixels per channel
+    const size_t   src_pitch    = size_t(width) * bpp;
+    const size_t   dst_pitch    = row_pitch ? row_pitch : size_t(dst_width) * bpp;
+    const uint32_t area         = uint32_t(scale) * scale;
+    const BYTE*    src          = static_cast<const BYTE*>(source->data());
+    BYTE*          dst          = static_cast<BYTE*>(dst_buffer->data()) + dst_offset;
+    for (uint32_t y = 0; y < dst_height; ++y) {
+        BYTE* dst_row = dst + y * dst_pitch;
+        for (uint32_t x = 0; x < dst_width; ++x)
+        for (uint32_t channel = 0; channel < bpp; ++channel) {
+            uint32_t sum = 0;
+            const BYTE* block = src + size_t(y) * scale * src_pitch + size_t(x) * scale * bpp + channel;
+            for (uint32_t sy = 0; sy < scale; ++sy, block += src_pitch)
+                for (uint32_t sx = 0; sx < scale; ++sx)
+                    sum += block[sx * bpp];
+            dst_row[x * bpp + channel] = static_cast<BYTE>((sum + area / 2) / area);
+        }
+    }
+    
+    if (!pitched) dst_buffer->set_size(buffer_size);
+    return dst_buffer;
+}
+__INTERNAL__HandlePool::__INTERNAL__HandlePool (Create create, Destroy destroy, size_t slots) :
+_create                                     (create),
+_destroy                                    (destroy),
+_count                                      (slots ? slots : 1),
+_slots                                      (std::make_unique<Slot[]>(_count))
+{
+    
+}
+__INTERNAL__HandlePool::~__INTERNAL__HandlePool ()
+{
+    for (size_t index = 0; index < _count; ++index)
+        if (auto handle = _slots[index].handle.exchange(nullptr))
+            _destroy (handle);
+}
+inline size_t HANDLE_POOL_START (size_t count)
+{
+    // Threads begin their slot search at a stable per-thread position so
+    // the same thread tends to reclaim the same (cache-warm) handle.
+    thread_local const size_t thread_hash =
+    std::hash<std::thread::id>{}(std::this_thread::get_id());
+    return thread_hash % count;
+}
+__INTERNAL__HandlePool::Handle __INTERNAL__HandlePool::acquire() const
+{
+    const size_t start = HANDLE_POOL_START(_count);
+    for (size_t step = 0; step < _count; ++step) {
+        auto& slot = _slots[(start + step) % _count].handle;
+        // Peek before the exchange to avoid dirtying empty slot cache lines
+        if (slot.load(std::memory_order_relaxed) == nullptr) continue;
+        if (auto handle = slot.exchange(nullptr, std::memory_order_acquire))
+            return handle;
+    }
+    return _create();
+}
+void __INTERNAL__HandlePool::release(Handle handle) const
+{
+    if (handle == nullptr) return;
+    const size_t start = HANDLE_POOL_START(_count);
+    for (size_t step = 0; step < _count; ++step) {
+        auto& slot = _slots[(start + step) % _count].handle;
+        if (slot.load(std::memory_order_relaxed) != nullptr) continue;
+        Handle EMPTY = nullptr;
+        if (slot.compare_exchange_strong(EMPTY, handle, std::memory_order_release))
+            return;
+    }
+    // The pool is saturated; this handle was surplus.
+    _destroy (handle);
+}
+// MARK: - PARALLEL WORK DISTRIBUTION
+struct ParallelBatch {
+    using Task                  = std::function<void(size_t)>;
+    const Task                  task;
+    const size_t                count;
+    std::atomic<size_t>         next;
+    std::atomic<size_t>         done;
+    std::atomic_flag            failed;
+    std::exception_ptr          exception;
+    ParallelBatch               (const Task& __task, size_t __count) :
+    task                        (__task),
+    count                       (__count),
+    next                        (0),
+    done                        (0) {}
+};
+inline void RUN_PARALLEL_BATCH (ParallelBatch& batch)
+{
+    // Claim indices one at a time until the batch is exhausted. Tiles vary
+    // considerably in decode cost so fine-grained claiming balances better
+    // than pre-partitioned ranges.
+    for (size_t index = batch.next.fetch_add(1, std::memory_order_relaxed);
+         index < batch.count;
+         index = batch.next.fetch_add(1, std::memory_order_relaxed)) {
+        try {
+            batch.task(index);
+        } catch (...) {
+            if (batch.failed.test_and_set() == false)
+                batch.exception = std::current_exception();
+        }
+        if (batch.done.fetch_add(1, std::memory_order_acq_rel) + 1 == batch.count)
+            batch.done.notify_all();
+    }
+}
 __INTERNAL__Context::__INTERNAL__Context    (const ContextCreateInfo& info) :
-_device                                     (nullptr)
+_device                                     (nullptr),
+_jpegCompressors                            (CREATE_JPEG_COMPRESSOR, DESTROY_JPEG_HANDLE,
+                                             2 * std::thread::hardware_concurrency()),
+_jpegDecompressors                          (CREATE_JPEG_DECOMPRESSOR, DESTROY_JPEG_HANDLE,
+                                             2 * std::thread::hardware_concurrency()),
+_avifDecoders                               (CREATE_AVIF_DECODER, DESTROY_AVIF_DECODER,
+                                             2 * std::thread::hardware_concurrency()),
+_quality                                    (QUALITY_DEFAULT),
+_subsampling                                (SUBSAMPLE_DEFAULT),
+_jpegOptimize                               (false),
+_tileDedup                                  (false),
+_avifSpeed                                  (AvifCodecOptions().speed),
+_avifThreads                                (AvifCodecOptions().threads),
+_avifAutoTiling                             (AvifCodecOptions().autoTiling),
+_workerCount                                (std::max(std::thread::hardware_concurrency(), 1U)),
+_tileCacheBudget                            (0)
 {
     
 }
 __INTERNAL__Context::~__INTERNAL__Context ()
 {
     
+}
+Quality __INTERNAL__Context::get_quality() const
+{
+    return _quality.load(std::memory_order_relaxed);
+}
+Subsampling __INTERNAL__Context::get_subsampling() const
+{
+    return _subsampling.load(std::memory_order_relaxed);
+}
+void __INTERNAL__Context::set_quality(Quality quality)
+{
+    _quality.store(CHECK_QUALITY_BOUNDS(quality), std::memory_order_relaxed);
+}
+void __INTERNAL__Context::set_subsampling(Subsampling subsampling)
+{
+    _subsampling.store(CHECK_SUBSAMPLING(subsampling), std::memory_order_relaxed);
+}
+bool __INTERNAL__Context::get_jpeg_optimize() const
+{
+    return _jpegOptimize.load(std::memory_order_relaxed);
+}
+void __INTERNAL__Context::set_jpeg_optimize(bool optimize)
+{
+    _jpegOptimize.store(optimize, std::memory_order_relaxed);
+}
+bool __INTERNAL__Context::get_tile_deduplication() const
+{
+    return _tileDedup.load(std::memory_order_relaxed);
+}
+void __INTERNAL__Context::set_tile_deduplication(bool deduplicate)
+{
+    _tileDedup.store(deduplicate, std::memory_order_relaxed);
+}
+size_t __INTERNAL__Context::get_tile_cache_budget() const
+{
+    return _tileCacheBudget.load(std::memory_order_relaxed);
+}
+void __INTERNAL__Context::set_tile_cache_budget(size_t bytes)
+{
+    _tileCacheBudget.store(bytes, std::memory_order_relaxed);
+}
+AvifCodecOptions __INTERNAL__Context::get_avif_options() const
+{
+    return AvifCodecOptions {
+        .speed          = _avifSpeed.load(std::memory_order_relaxed),
+        .threads        = _avifThreads.load(std::memory_order_relaxed),
+        .autoTiling     = _avifAutoTiling.load(std::memory_order_relaxed),
+    };
+}
+void __INTERNAL__Context::set_avif_options(const AvifCodecOptions &options)
+{
+    if (options.speed < 0 || options.speed > 10) throw std::runtime_error
+        ("AVIF encoder speed must be within 0 (slowest) to 10 (fastest)");
+    if (options.threads < 1) throw std::runtime_error
+        ("AVIF codec thread count must be at least 1");
+    _avifSpeed.store        (options.speed,         std::memory_order_relaxed);
+    _avifThreads.store      (options.threads,       std::memory_order_relaxed);
+    _avifAutoTiling.store   (options.autoTiling,    std::memory_order_relaxed);
+}
+void __INTERNAL__Context::parallel_for(size_t count, const std::function<void(size_t)>& task) const
+{
+    if (count == 0) return;
+    if (count == 1) return task(0);
+    
+    // The worker pool is only spun up the first time it is needed; most
+    // single-tile consumers of a context never pay for it.
+    std::call_once(_workersCreated, [this](){
+        _workers = Async::createThreadPool(_workerCount);
+    });
+    if (!_workers) throw std::runtime_error
+        ("Failed to create the codec context worker pool");
+    
+    // Helpers hold their own reference to the batch; a helper that is
+    // dequeued after the batch has finished simply finds no work left.
+    auto batch = std::make_shared<ParallelBatch>(task, count);
+    const size_t helpers = std::min<size_t>(count - 1, _workerCount);
+    for (size_t helper = 0; helper < helpers; ++helper)
+        _workers->issue_task([batch](){
+            RUN_PARALLEL_BATCH(*batch);
+        });
+    
+    // The calling thread works the batch as well. This also guarantees
+    // forward progress if parallel_for is invoked from a worker thread.
+    RUN_PARALLEL_BATCH(*batch);
+    for (auto done = batch->done.load(std::memory_order_acquire); done < count;
+         done = batch->done.load(std::memory_order_acquire))
+        batch->done.wait(done, std::memory_order_acquire);
+    
+    if (batch->exception)
+        std::rethrow_exception(batch->exception);
 }
 Buffer __INTERNAL__Context::compress_tile(const CompressTileInfo &info) const
 {
@@ -600,16 +986,21 @@ Buffer __INTERNAL__Context::compress_tile(const CompressTileInfo &info) const
             throw std::runtime_error("Encoding format in CompressTileInfo is undefined");
             return Buffer();
         case TILE_ENCODING_JPEG:
-            return COMPRESS_JPEG        (info.pixelArray,
+            return COMPRESS_JPEG        (_jpegCompressors,
+                                         info.pixelArray,
+                                         info.optionalDestination,
                                          info.format,
                                          info.quality,
                                          info.subsampling,
                                          TILE_PIX_LENGTH,
-                                         TILE_PIX_LENGTH);
+                                         TILE_PIX_LENGTH,
+                                         get_jpeg_optimize());
         case TILE_ENCODING_AVIF:
             if (_gpuAV1Encode) {
                 assert(false && "HARDWARE ENCODER AV1 IMPLEMENTATION NOT YET BUILT");
-            } return COMPRESS_AVIF_CPU (info.pixelArray,
+            } return COMPRESS_AVIF_CPU (get_avif_options(),
+                                        info.pixelArray,
+                                        info.optionalDestination,
                                         info.format,
                                         info.quality,
                                         info.subsampling,
@@ -625,23 +1016,61 @@ Buffer __INTERNAL__Context::decompress_tile(const DecompressTileInfo &info) cons
 {
     if (info.compressed == NULL) throw std::runtime_error
         ("Cannot decompress tile without a valid compressed source buffer");
+    switch (info.scale) {
+        case DECODE_SCALE_FULL:
+        case DECODE_SCALE_HALF:
+        case DECODE_SCALE_QUARTER:
+        case DECODE_SCALE_EIGHTH: break;
+        default: throw std::runtime_error
+            ("Invalid decode scale in DecompressTileInfo");
+    }
     switch (info.encoding) {
         case TILE_ENCODING_UNDEFINED:
             throw std::runtime_error("Encoding format in DecompressTileInfo is undefined");
         case TILE_ENCODING_JPEG:
-            return DECOMPRESS_JPEG      (info.compressed,
+            return DECOMPRESS_JPEG      (_jpegDecompressors,
+                                         info.compressed,
                                          info.optionalDestination,
                                          info.desiredFormat,
                                          TILE_PIX_LENGTH,
-                                         TILE_PIX_LENGTH);
+                                         TILE_PIX_LENGTH,
+                                         info.destinationOffset,
+                                         info.rowPitch,
+                                         info.scale);
         case TILE_ENCODING_AVIF:
             if (_gpuAV1Decode) {
                 assert(false && "HARDWARE ENCODER AV1 IMPLEMENTATION NOT YET BUILT");
-            } return DECOMPRESS_AVIF_CPU (info.compressed,
-                                          info.optionalDestination,
-                                          info.desiredFormat,
-                                          TILE_PIX_LENGTH,
-                                          TILE_PIX_LENGTH);
+            }
+            // AV1 has no reduced resolution decode; decode in full into
+            // per-thread scratch and box filter into the destination.
+            if (info.scale != DECODE_SCALE_FULL) {
+                thread_local Buffer full = Create_strong_buffer(TILE_PIX_AREA * 4);
+                auto decoded = DECOMPRESS_AVIF_CPU (_avifDecoders,
+                                                    get_avif_options(),
+                                                    info.compressed,
+                                                    full,
+                                                    info.desiredFormat,
+                                                    TILE_PIX_LENGTH,
+                                                    TILE_PIX_LENGTH);
+                if (!decoded) return NULL;
+                return DOWNSAMPLE_BOX (decoded,
+                                       info.optionalDestination,
+                                       info.desiredFormat,
+                                       TILE_PIX_LENGTH,
+                                       TILE_PIX_LENGTH,
+                                       info.scale,
+                                       info.destinationOffset,
+                                       info.rowPitch);
+            }
+            return DECOMPRESS_AVIF_CPU (_avifDecoders,
+                                        get_avif_options(),
+                                        info.compressed,
+                                        info.optionalDestination,
+                                        info.desiredFormat,
+                                        TILE_PIX_LENGTH,
+                                        TILE_PIX_LENGTH,
+                                        info.destinationOffset,
+                                        info.rowPitch);
         case TILE_ENCODING_IRIS:
             assert(false && "IMPLEMENTATION NOT YET BUILT");
             break;
@@ -661,7 +1090,9 @@ Buffer __INTERNAL__Context::compress_image(const CompressImageInfo &info) const
             
             break;
         case IMAGE_ENCODING_JPEG:
-            return COMPRESS_JPEG        (info.pixelArray,
+            return COMPRESS_JPEG        (_jpegCompressors,
+                                         info.pixelArray,
+                                         NULL,
                                          info.format,
                                          info.quality,
                                          info.subsampling,
@@ -672,7 +1103,9 @@ Buffer __INTERNAL__Context::compress_image(const CompressImageInfo &info) const
             if (_gpuAV1Decode) {
                 assert(false && "HARDWARE ENCODER AV1 IMPLEMENTATION NOT YET BUILT");
             }
-            return COMPRESS_AVIF_CPU    (info.pixelArray,
+            return COMPRESS_AVIF_CPU    (get_avif_options(),
+                                         info.pixelArray,
+                                         NULL,
                                          info.format,
                                          info.quality,
                                          info.subsampling,
@@ -694,7 +1127,8 @@ Buffer __INTERNAL__Context::decompress_image(const DecompressImageInfo &info) co
                                          info.height);
             
         case IMAGE_ENCODING_JPEG:
-            return DECOMPRESS_JPEG      (info.compressed,
+            return DECOMPRESS_JPEG      (_jpegDecompressors,
+                                         info.compressed,
                                          info.optionalDestination,
                                          info.desiredFormat,
                                          info.width,
@@ -703,7 +1137,9 @@ Buffer __INTERNAL__Context::decompress_image(const DecompressImageInfo &info) co
         case IMAGE_ENCODING_AVIF:
             if (_gpuAV1Decode) {
                 assert(false && "HARDWARE ENCODER AV1 IMPLEMENTATION NOT YET BUILT");
-            } return DECOMPRESS_AVIF_CPU (info.compressed,
+            } return DECOMPRESS_AVIF_CPU (_avifDecoders,
+                                          get_avif_options(),
+                                          info.compressed,
                                           info.optionalDestination,
                                           info.desiredFormat,
                                           info.width,
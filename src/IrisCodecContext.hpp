@@ -9,10 +9,53 @@
 #define IrisCodecContext_hpp
 namespace IrisCodec {
 using namespace Iris;
+/// Pool of reusable codec library handles (ex. TurboJPEG tjhandles).
+///
+/// Handles are parked in a fixed array of cache-line sized atomic slots.
+/// Acquiring is a single exchange and releasing a single compare-exchange,
+/// so concurrent tile codecs never serialize on a mutex. Each thread begins
+/// its search at a slot derived from its thread id and therefore tends to
+/// get back the same handle it released. If the pool is empty a new handle
+/// is created; if the pool is full a released handle is destroyed.
+class __INTERNAL__HandlePool {
+public:
+    using Handle                        = void*;
+    using Create                        = Handle (*)();
+    using Destroy                       = void   (*)(Handle);
+private:
+    struct alignas(64) Slot {
+        std::atomic<Handle>             handle          = nullptr;
+    };
+    const Create                        _create;
+    const Destroy                       _destroy;
+    const size_t                        _count;
+    const std::unique_ptr<Slot[]>       _slots;
+public:
+    explicit __INTERNAL__HandlePool     (Create, Destroy, size_t slots);
+    __INTERNAL__HandlePool              (const __INTERNAL__HandlePool&) = delete;
+    __INTERNAL__HandlePool operator =   (const __INTERNAL__HandlePool&) = delete;
+   ~__INTERNAL__HandlePool              ();
+    Handle      acquire                 () const;
+    void        release                 (Handle) const;
+};
 class __INTERNAL__Context {
     Device                              _device         = NULL;
     bool                                _gpuAV1Decode   = false;
     bool                                _gpuAV1Encode   = false;
+    const __INTERNAL__HandlePool        _jpegCompressors;
+    const __INTERNAL__HandlePool        _jpegDecompressors;
+    const __INTERNAL__HandlePool        _avifDecoders;
+    std::atomic<Quality>                _quality;
+    std::atomic<Subsampling>            _subsampling;
+    std::atomic<bool>                   _jpegOptimize;
+    std::atomic<bool>                   _tileDedup;
+    std::atomic<int>                    _avifSpeed;
+    std::atomic<int>                    _avifThreads;
+    std::atomic<bool>                   _avifAutoTiling;
+    const uint32_t                      _workerCount;
+    mutable std::once_flag              _workersCreated;
+    mutable Async::ThreadPool           _workers        = NULL;
+    std::atomic<size_t>                 _tileCacheBudget;
 public:
     explicit __INTERNAL__Context        (const ContextCreateInfo&);
     __INTERNAL__Context                 (const __INTERNAL__Context&) = delete;
@@ -22,6 +65,24 @@ public:
     Subsampling get_subsampling         () const;
     void        set_quality             (Quality);
     void        set_subsampling         (Subsampling);
+    /// Generate optimal JPEG Huffman tables per tile (smaller, slower encode)
+    bool        get_jpeg_optimize       () const;
+    void        set_jpeg_optimize       (bool);
+    /// Share the stored bytes of byte-identical compressed tiles when encoding
+    bool        get_tile_deduplication  () const;
+    void        set_tile_deduplication  (bool);
+    /// Decoded tile cache byte budget given to slides opened with this context
+    size_t      get_tile_cache_budget   () const;
+    void        set_tile_cache_budget   (size_t bytes);
+    /// AV1 encoder speed, codec threading and tiling used for AVIF streams
+    AvifCodecOptions get_avif_options   () const;
+    void        set_avif_options        (const AvifCodecOptions&);
+    
+    /// Invoke task(index) for every index in [0, count) across the context's
+    /// worker threads. The calling thread participates in the work and the
+    /// call returns only once every index has completed. The first exception
+    /// thrown by any task is rethrown to the caller.
+    void        parallel_for            (size_t count, const std::function<void(size_t)>& task) const;
     
     Buffer compress_tile                (const CompressTileInfo&) const;
     Buffer decompress_tile              (const DecompressTileInfo&) const;
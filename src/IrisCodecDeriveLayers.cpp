@@ -242,10 +242,14 @@ inline void DOWNSAMPLE_TILE (const DerivationInfo& info,
         case TILE_READING:
             break;
             
+        // A tile restored complete from a checkpoint needs no subtiles; its
+        // subtiles are only read again if their own bytes were not journaled
+        case TILE_COMPLETE:
+            if (tile.restored) return;
+            
         // These flags should NEVER fire here
         case TILE_PENDING:
         case TILE_ENCODING:
-        case TILE_COMPLETE:
             std::cerr   << "ENCODE_DOWNSAMPLE_TILE synchronization error. "
                         << "Set a breakpoint in " << __FILE__
                         << " line " << __LINE__ << "to debug\n";
@@ -271,6 +275,17 @@ inline void DOWNSAMPLE_TILE (const DerivationInfo& info,
         ENQUEUE_NEXT_TILE(n_l,n_y,n_x);
     }
 }
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~ TILE STORAGE ~~~~~~~~~~~~~~~~~~~~~~~~~ //
+void STORE_ENCODED_TILE (const Context& ctx,
+                         const File& file,
+                         atomic_uint64& offset,
+                         EncoderTracker& tracker,
+                         TileEntry& entry,
+                         const Buffer& pixels,
+                         Format format,
+                         Encoding encoding,
+                         Buffer bytes);
+// ~~~~~~~~~~~~~~~~~~~~~~~~ END TILE STORAGE ~~~~~~~~~~~~~~~~~~~~~~~ //
 void ENCODE_DERIVED_TILE (const DerivationInfo& info,
                           AtomicEncoderStatus* _status,
                           uint32_t l, uint32_t y, uint32_t x) {
@@ -311,41 +326,14 @@ void ENCODE_DERIVED_TILE (const DerivationInfo& info,
             (std::bind(ENCODE_DERIVED_TILE,info, _status, _l, _y, _x));
         });
         // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ //
-        //  COMPRESS PIXEL ARRAY STEP
-        //  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ //
-        auto& stream = tile.stream; // Compressed byte stream
-        if (!stream) {
-            stream = info.context->compress_tile({
-                .pixelArray = tile.pixels,
-                .format     = table.format,
-                .encoding   = table.encoding
-            });
-        } if (!stream) throw std::runtime_error
-            ("Failed to compress slide image data");
-        //  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ //
-        //  WRITE TO FILE STEP
+        //  COMPRESS AND WRITE TO FILE STEP
         //  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ //
-        auto& file      = info.file;
-        auto& entry     = table.layers[l][t];
-        entry.size      = U32_CAST(stream->size());
-        entry.offset    = info.offset.fetch_add(entry.size);
-        ReadLock shared_write_lock (file->resize);
-        if (entry.offset + entry.size > file->size) {
-            shared_write_lock.unlock();
-            WriteLock resize_lock (file->resize);
-            // Expand the file by 500 MB per expansion
-            // We will shrink it back down to size at the end.
-            auto result = resize_file(file, FileResizeInfo {
-                .size = file->size + (size_t)5E8,
-            });
-            if (result != IRIS_SUCCESS)
-                throw std::runtime_error("Failed to resize growing tile blocks");
-            resize_lock.unlock();
-            shared_write_lock.lock();
-        }
-        auto dst = file->ptr + entry.offset;
-        memcpy(dst, stream->data(), entry.size);
-        shared_write_lock.unlock();
+        //  Source pass-through tiles arrive with their compressed stream.
+        //  Tiles restored from a checkpoint are already within the file.
+        if (tile.restored == false)
+            STORE_ENCODED_TILE (info.context, info.file, info.offset, tracker,
+                                table.layers[l][t], tile.pixels,
+                                table.format, table.encoding, tile.stream);
         //  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ //
         //  RELEASE TILE STEP
         //  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ //
@@ -155,6 +155,46 @@ Result get_encoder_progress (const Encoder &encoder, EncoderProgress &progress)
         };
     } return IRIS_FAILURE;
 }
+Result get_encoder_dedup_stats (const Encoder &encoder, EncoderDedupStats &stats) noexcept
+{
+    try {
+        CHECK_ENCODER(encoder);
+        return encoder->get_dedup_stats(stats);
+    } catch (std::runtime_error&e) {
+        return Result {
+            IRIS_FAILURE,
+            e.what()
+        };
+    } return IRIS_FAILURE;
+}
+Result set_encoder_write_backend (const Encoder &encoder, FileWriteBackend backend) noexcept
+{
+    try {
+        CHECK_ENCODER(encoder);
+        CHECK_MUTABLE(encoder);
+        encoder->set_write_backend(backend);
+        return IRIS_SUCCESS;
+    } catch (std::runtime_error&e) {
+        return {
+            IRIS_FAILURE,
+            e.what()
+        };
+    }
+}
+Result set_encoder_checkpoints (const Encoder &encoder, const EncoderCheckpointOptions &options) noexcept
+{
+    try {
+        CHECK_ENCODER(encoder);
+        CHECK_MUTABLE(encoder);
+        encoder->set_checkpoints(options);
+        return IRIS_SUCCESS;
+    } catch (std::runtime_error&e) {
+        return {
+            IRIS_FAILURE,
+            e.what()
+        };
+    }
+}
 Result get_encoder_src(const Encoder &encoder, std::string &src_string) noexcept
 {
     try {
@@ -260,6 +300,9 @@ std::string __INTERNAL__Encoder::get_dst_path() const
 Encoding __INTERNAL__Encoder::get_encoding() const {
     return _encoding;
 }
+FileWriteBackend __INTERNAL__Encoder::get_write_backend() const {
+    return _writeBackend;
+}
 Result __INTERNAL__Encoder::get_encoder_progress (EncoderProgress &progress) const
 {
     progress.dstFilePath    = _dstPath;
@@ -283,6 +326,16 @@ Result __INTERNAL__Encoder::get_encoder_progress (EncoderProgress &progress) con
             return IRIS_SUCCESS;
     }   return IRIS_FAILURE;
 }
+Result __INTERNAL__Encoder::get_dedup_stats (EncoderDedupStats &stats) const
+{
+    stats.tilesWritten      = _tracker.completed.load();
+    stats.tilesShared       = _tracker.shared.load();
+    stats.bytesSaved        = _tracker.shared_bytes.load();
+    stats.ratio             = stats.tilesWritten ?
+                              static_cast<float>(stats.tilesShared) /
+                              static_cast<float>(stats.tilesWritten) : 0.f;
+    return IRIS_SUCCESS;
+}
 // MARK: Setters
 void __INTERNAL__Encoder::set_src_path(const std::string &source)
 {
@@ -312,6 +365,26 @@ void __INTERNAL__Encoder::set_encoding(Encoding desired_encoding)
     }
     _encoding = desired_encoding;
 }
+void __INTERNAL__Encoder::set_write_backend(FileWriteBackend backend)
+{
+    switch (_status) {
+        case ENCODER_INACTIVE:break;
+        default:
+            throw std::runtime_error("Encoder is currently active; cannot change write backend");
+    }
+    _writeBackend = backend;
+}
+void __INTERNAL__Encoder::set_checkpoints(const EncoderCheckpointOptions &options)
+{
+    switch (_status) {
+        case ENCODER_INACTIVE:break;
+        default:
+            throw std::runtime_error("Encoder is currently active; cannot change checkpoint options");
+    }
+    if (options.enabled && options.interval == 0) throw std::runtime_error
+        ("Encoder checkpoints require an interval of at least one second");
+    _checkpoints = options;
+}
 Result __INTERNAL__Encoder::reset_encoder()
 {
     switch (_status) {
@@ -372,7 +445,7 @@ inline Extent READ_EXTENT_OPENSLIDE (openslide_t* openslide)
     
     return extent;
 }
-inline Buffer READ_OPENSLIDE_TILE (const EncoderSource src, LayerIndex __LI, TileIndex __TI)
+inline Buffer READ_OPENSLIDE_TILE (const EncoderSource src, LayerIndex __LI, TileIndex __TI, Buffer buffer)
 {
     const auto os       = src.openslide;
     if (os == NULL)                                     return NULL;
@@ -380,7 +453,6 @@ inline Buffer READ_OPENSLIDE_TILE (const EncoderSource src, LayerIndex __LI, Til
     if (__LI    >= extent.layers.size())                return NULL;
     auto& __LE   = extent.layers[__LI];
     if (__TI    >= __LE.xTiles * __LE.yTiles)           return NULL;
-    auto buffer         = Create_strong_buffer  (TILE_PIX_BYTES_RGBA);
     auto& level_extent  = extent.layers[__LI];
     auto openSlideLevel = static_cast<uint32_t> ((extent.layers.size()-1)-__LI);
     auto x_tile_index   = static_cast<float>    (__TI % level_extent.xTiles);
@@ -563,6 +635,54 @@ inline Metadata READ_DICOM_METADATA (const EncoderSource src, const Extent& exte
     return metadata;
 }
 // MARK: - APERIO SPECIFIC METHODS
+#if IRIS_INCLUDE_TIFF
+SvsFile  open_svs_file               (const std::filesystem::path&);
+uint32_t get_svs_number_of_levels    (SvsFile svs);
+uint32_t get_svs_layer_width         (SvsFile svs, unsigned level);
+uint32_t get_svs_layer_height        (SvsFile svs, unsigned level);
+Encoding get_svs_encoding            (SvsFile svs);
+Buffer   get_svs_tile_stream         (SvsFile svs, unsigned level, unsigned tile);
+Buffer   read_svs_tile               (SvsFile svs, unsigned level, unsigned tile, Buffer dst);
+Metadata get_svs_metadata            (SvsFile svs, bool anonymize);
+AssociatedImageInfo get_svs_associated_image_info (SvsFile svs, const std::string& label);
+Buffer   read_svs_associated_image   (SvsFile svs, const AssociatedImageInfo& info);
+inline Extent READ_EXTENT_SVS (SvsFile svs)
+{
+    Extent          extent;
+    
+    // SVS levels are ordered lowest to highest resolution, like Iris layers
+    auto n_levels   = get_svs_number_of_levels (svs);
+    extent.width    = get_svs_layer_width (svs, 0);
+    extent.height   = get_svs_layer_height(svs, 0);
+    extent.layers   = LayerExtents(n_levels);
+    for (auto level = 0U; level < n_levels; ++level) {
+        auto& __e   = extent.layers[level];
+        auto width  = get_svs_layer_width (svs, level);
+        auto height = get_svs_layer_height(svs, level);
+        __e.xTiles  = (width/TILE_PIX_LENGTH) + (width%TILE_PIX_LENGTH?1:0);
+        __e.yTiles  = (height/TILE_PIX_LENGTH) + (height%TILE_PIX_LENGTH?1:0);
+        __e.scale   =  width > height ?
+        F32_CAST(width)/F32_CAST(extent.width) :
+        F32_CAST(height)/F32_CAST(extent.height);
+    }
+    for (auto extent_IT = extent.layers.begin(); extent_IT != extent.layers.end(); extent_IT++)
+        extent_IT->downsample = extent.layers.back().scale / extent_IT->scale;
+    
+    return extent;
+}
+inline Metadata READ_SVS_METADATA (const EncoderSource src, const Extent& extent, bool anonymize) {
+    Metadata metadata = get_svs_metadata (src.svsFile, anonymize);
+    metadata.codec    = get_codec_version();
+    
+    // Normalize to the lowest resolution layer as with OpenSlide sources;
+    // rounded to the 1000ths.
+    metadata.micronsPerPixel = round(metadata.micronsPerPixel *
+                                     extent.layers.front().downsample * 1000.f)/1000.f;
+    metadata.magnification   = round(metadata.magnification /
+                                     extent.layers.front().downsample * 1000.f)/1000.f;
+    return metadata;
+}
+#endif
 
 // MARK: - FILE ENCODING METHODS
 inline EncoderSource OPEN_SOURCE (const std::string& path_, const Context context = NULL)
@@ -582,8 +702,9 @@ inline EncoderSource OPEN_SOURCE (const std::string& path_, const Context contex
         if (!source.irisSlide) throw std::runtime_error
             ("No valid Iris slide returned from IrisCodec::open_slide");
         
-        source.extent       = source.irisSlide->get_slide_info().extent;
-        source.format       = source.irisSlide->get_slide_info().format;
+        source.extent       = source.irisSlide->get_slide_extent();
+        source.format       = source.irisSlide->get_slide_format();
+        source.encoding     = source.irisSlide->get_slide_info().encoding;
             
         return source;
     }
@@ -606,14 +727,25 @@ inline EncoderSource OPEN_SOURCE (const std::string& path_, const Context contex
         goto TRY_OPENSLIDE;
     }
     
+    #if IRIS_INCLUDE_TIFF
     if (path.extension() == ".svs") try {
-        // SVS WILL GO HERE
+        if (auto handle = open_svs_file(path)) {
+            EncoderSource source;
+            source.sourceType   = EncoderSource::ENCODER_SRC_APERIO;
+            source.svsFile      = handle;
+            source.extent       = READ_EXTENT_SVS(handle);
+            source.format       = FORMAT_R8G8B8A8; // Decoded tiles are RGBA
+            source.encoding     = get_svs_encoding(handle);
+            
+            return source;
+        }
     } catch (std::runtime_error &e) {
         std::cout   << "[WARNING] Failed to establish Aperio SVS source \'"
                     << path_ << "\' as an encoder source: "
                     << e.what() << ". Reattempting using OpenSlide.\n";
         goto TRY_OPENSLIDE;
     }
+    #endif
     TRY_OPENSLIDE:
     #if IRIS_INCLUDE_OPENSLIDE
     if (openslide_detect_vendor(path_.c_str())) {
@@ -647,6 +779,14 @@ inline BYTE* FILE_CHECK_EXPAND (const File& file, size_t required_size)
             ("Failed to resize slide file "+file->path+": " + result.message);
     } return file->ptr;
 }
+// Reuse a caller's (empty) scratch buffer if it can hold a full RGBA tile
+inline Buffer RGBA_TILE_DESTINATION (const Buffer& scratch)
+{
+    if (scratch && scratch->capacity() >= TILE_PIX_BYTES_RGBA) {
+        scratch->set_size(0);
+        return scratch;
+    }   return Create_strong_buffer(TILE_PIX_BYTES_RGBA);
+}
 inline Buffer GET_SOURCE_TILE (const EncoderSource& src, LayerIndex layer, TileIndex tile)
 {
     switch (src.sourceType) {
@@ -662,11 +802,19 @@ inline Buffer GET_SOURCE_TILE (const EncoderSource& src, LayerIndex layer, TileI
         case EncoderSource::ENCODER_SRC_DICOM:
             return GET_DICOM_TILE(src, layer, tile);
         case EncoderSource::ENCODER_SRC_APERIO:
-            throw std::runtime_error("APERIO TIFF reads not yet built; Use openslide for the moment");
+            #if IRIS_INCLUDE_TIFF
+            return get_svs_tile_stream(src.svsFile, layer, tile);
+            #else
+            throw std::runtime_error("libtiff linkage was NOT compiled into this binary. Aperio SVS files may only be read through OpenSlide.");
+            #endif
     }
     return NULL;
 }
-inline Buffer READ_SOURCE_TILE (const Context& ctx, const EncoderSource& src, LayerIndex layer, TileIndex tile)
+inline Buffer READ_SOURCE_TILE (const Context& ctx,
+                                const EncoderSource& src,
+                                LayerIndex layer,
+                                TileIndex tile,
+                                const Buffer& scratch = NULL)
 {
     switch (src.sourceType) {
         case EncoderSource::ENCODER_SRC_UNDEFINED: throw std::runtime_error("Cannot read source tile; undefined source");
@@ -675,10 +823,11 @@ inline Buffer READ_SOURCE_TILE (const Context& ctx, const EncoderSource& src, La
                 .slide          = src.irisSlide,
                 .layerIndex     = layer,
                 .tileIndex      = tile,
+                .optionalDestination = scratch,
                 .desiredFormat  = FORMAT_R8G8B8A8});
         case EncoderSource::ENCODER_SRC_OPENSLIDE:
             #if IRIS_INCLUDE_OPENSLIDE
-            return READ_OPENSLIDE_TILE (src, layer, tile);
+            return READ_OPENSLIDE_TILE (src, layer, tile, RGBA_TILE_DESTINATION(scratch));
             #else
             throw std::runtime_error("Openslide linkage was NOT compiled into this binary. Request a new version of Iris Codec with OpenSlide support if you would like to decode slide scanning vendor slide files only accessable to OpenSlide.");
             #endif
@@ -686,15 +835,354 @@ inline Buffer READ_SOURCE_TILE (const Context& ctx, const EncoderSource& src, La
         case EncoderSource::ENCODER_SRC_DICOM: {
             return ctx->decompress_tile({
                 .compressed     = GET_DICOM_TILE(src, layer, tile),
+                .optionalDestination = scratch,
                 .desiredFormat  = FORMAT_R8G8B8A8,
                 .encoding       = get_dicom_encoding(src.dicomFile)
             });
         }
         case EncoderSource::ENCODER_SRC_APERIO:
-            throw std::runtime_error("APERIO TIFF reads not yet built; Use openslide for the moment");
+            #if IRIS_INCLUDE_TIFF
+            return read_svs_tile(src.svsFile, layer, tile, RGBA_TILE_DESTINATION(scratch));
+            #else
+            throw std::runtime_error("libtiff linkage was NOT compiled into this binary. Aperio SVS files may only be read through OpenSlide.");
+            #endif
     }
     return NULL;
 }
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~ TILE STORAGE ~~~~~~~~~~~~~~~~~~~~~~~~~ //
+inline bool UNIFORM_TILE_KEY (const Buffer& pixels, Format format, uint32_t& key)
+{
+    // Tile pixel buffers are not always sized; they are always a full tile
+    const auto  channels = format == FORMAT_B8G8R8 || format == FORMAT_R8G8B8 ? 3 : 4;
+    if (!pixels || pixels->capacity() < TILE_PIX_AREA * channels) return false;
+    const auto  data     = static_cast<const BYTE*>(pixels->data());
+    if (is_uniform_pixels(data, TILE_PIX_AREA, format) == false)
+        return false;
+    key = 0;
+    memcpy(&key, data, channels);
+    return true;
+}
+inline uint64_t HASH_TILE_BYTES (const Buffer& bytes)
+{
+    // Multiply / xor-shift over 8 byte words, seeded with the stream length.
+    // Only used to find candidates; matches are confirmed byte for byte.
+    const auto  data    = static_cast<const BYTE*>(bytes->data());
+    const auto  size    = bytes->size();
+    uint64_t    hash    = 0x9E3779B97F4A7C15ULL ^ size;
+    size_t      i       = 0;
+    for (uint64_t word; i + sizeof(word) <= size; i += sizeof(word)) {
+        memcpy(&word, data + i, sizeof(word));
+        hash  = (hash ^ word) * 0xFF51AFD7ED558CCDULL;
+        hash ^= hash >> 32;
+    }
+    uint64_t tail = 0;
+    memcpy(&tail, data + i, size - i);
+    hash  = (hash ^ tail) * 0xC4CEB9FE1A85EC53ULL;
+    return hash ^ (hash >> 29);
+}
+inline bool FIND_HASHED_TILE (const File& file,
+                              TileHashRegistry& registry,
+                              uint64_t hash,
+                              const Buffer& bytes,
+                              TileEntry& entry)
+{
+    TileEntry candidate;
+    {
+        auto& shard = registry.shards[hash % TileHashRegistry::shard_count];
+        MutexLock __ (shard.mutex);
+        auto stored = shard.entries.find(hash);
+        if (stored == shard.entries.end()) return false;
+        candidate   = stored->second;
+    }
+    if (candidate.size != bytes->size()) return false;
+    auto shared_read_lock = file->read_lock();
+    if (memcmp(file->ptr + candidate.offset, bytes->data(), candidate.size))
+        return false;
+    entry = candidate;
+    return true;
+}
+inline void REGISTER_HASHED_TILE (TileHashRegistry& registry, uint64_t hash, const TileEntry& entry)
+{
+    auto& shard = registry.shards[hash % TileHashRegistry::shard_count];
+    MutexLock __ (shard.mutex);
+    shard.entries.emplace(hash, entry);
+}
+inline void FLUSH_WRITE_STAGE (const File& file,
+                               WriteExtent& extent,
+                               TileHashRegistry& registry,
+                               bool retire)
+{
+    auto& stage = extent.stage;
+    // Write the whole blocks staged; a partial trailing block is carried
+    // forward unless the extent is retiring, when it is padded into the
+    // unused (block aligned) extent tail that compaction later reclaims.
+    constexpr Size alignment = WriteStage::alignment;
+    const Size blocks = retire ?
+                        (stage.size + alignment-1) & ~(alignment-1) :
+                        stage.size & ~(alignment-1);
+    if (blocks == 0) return;
+    if (blocks > stage.size) memset(stage.data.get() + stage.size, 0, blocks - stage.size);
+    auto result = write_file(file, FileWriteInfo {
+        .offset     = stage.offset,
+        .data       = stage.data.get(),
+        .size       = blocks,
+    }); if (result != IRIS_SUCCESS)
+        throw std::runtime_error(result.message);
+    
+    // The bytes of these tiles are now within the file to be compared
+    const Offset written = stage.offset + std::min(blocks, stage.size);
+    extent.written.store(written, std::memory_order_release);
+    auto pending = std::partition(stage.hashes.begin(), stage.hashes.end(),
+                                  [written](const WriteStage::Pending::value_type& __h) {
+        return __h.second.offset + __h.second.size > written;
+    });
+    for (auto it = pending; it != stage.hashes.end(); ++it)
+        REGISTER_HASHED_TILE(registry, it->first, it->second);
+    stage.hashes.erase(pending, stage.hashes.end());
+    
+    if (retire) {
+        stage.data.reset();
+        stage.size = 0;
+        return;
+    }
+    memmove(stage.data.get(), stage.data.get() + blocks, stage.size - blocks);
+    stage.offset   += blocks;
+    stage.size     -= blocks;
+}
+inline void STAGE_TILE_BYTES (const File& file,
+                              WriteExtent& extent,
+                              TileHashRegistry& registry,
+                              const BYTE* data,
+                              Size size)
+{
+    auto& stage = extent.stage;
+    // Tiles are packed back to back within an extent, so the stage always
+    // holds a contiguous run of the file ending where this tile begins.
+    while (size) {
+        const Size copy = std::min(size, WriteStage::capacity - stage.size);
+        memcpy(stage.data.get() + stage.size, data, copy);
+        stage.size += copy;
+        data       += copy;
+        size       -= copy;
+        if (stage.size == WriteStage::capacity)
+            FLUSH_WRITE_STAGE(file, extent, registry, false);
+    }
+}
+inline WriteExtent& RESERVE_TILE_BYTES (const File& file,
+                                        atomic_uint64& offset,
+                                        EncoderTracker& tracker,
+                                        uint32_t size)
+{
+    struct Cursor {
+        const WriteExtentRegistry*  registry    = NULL;
+        uint64_t                    epoch       = 0;
+        WriteExtent*                extent      = NULL;
+    };
+    auto& registry = tracker.writes;
+    thread_local Cursor cursor;
+    if (cursor.registry != &registry || cursor.epoch != registry.epoch)
+        cursor = Cursor {&registry, registry.epoch, NULL};
+    
+    auto extent = cursor.extent;
+    if (!extent || extent->next + size > extent->end) {
+        // Write out what remains staged of the extent being left behind
+        if (extent) extent->retired = true;
+        if (extent && extent->stage.data)
+            FLUSH_WRITE_STAGE(file, *extent, tracker.hashed, true);
+        
+        // Reserve a new extent from the shared offset; this is the only
+        // point at which tile writers touch it or grow the file.
+        constexpr Size alignment = WriteStage::alignment;
+        const Size   reserve = (std::max<Size>(WriteExtentRegistry::extent_size, size)
+                                + alignment-1) & ~(alignment-1);
+        const Offset start   = offset.fetch_add(reserve);
+        {
+            MutexLock __ (registry.mutex);
+            registry.extents.emplace_back(start, start + reserve, start);
+            extent = cursor.extent = &registry.extents.back();
+        }
+        if (file->backend != FILE_WRITE_MAPPED) {
+            extent->stage.data.reset(static_cast<BYTE*>(::operator new
+                (WriteStage::capacity, std::align_val_t(alignment))));
+            extent->stage.offset = start;
+        }
+        WriteLock resize_lock (file->resize);
+        if (extent->end > file->size) {
+            // Expand the file by at least 500 MB per expansion
+            // We will shrink it back down to size at the end.
+            auto result = resize_file(file, FileResizeInfo {
+                .size = std::max<size_t>(extent->end, file->size + (size_t)5E8),
+            });
+            if (result != IRIS_SUCCESS)
+                throw std::runtime_error("Failed to resize growing tile blocks");
+        }
+    }
+    return *extent;
+}
+inline void FLUSH_WRITE_EXTENTS (const File& file, EncoderTracker& tracker)
+{
+    // All writers have joined; write out the stages they still hold
+    for (auto& extent : tracker.writes.extents)
+        if (extent.stage.data)
+            FLUSH_WRITE_STAGE(file, extent, tracker.hashed, true);
+}
+inline void COMPACT_WRITE_EXTENTS (const File& file,
+                                   WriteExtentRegistry& registry,
+                                   Abstraction::TileTable& table,
+                                   atomic_uint64& offset)
+{
+    // All writers have joined. Each extent holds its tiles packed from its
+    // start to its next offset; what remains up to its end is dead space.
+    // An extent is retired only once a tile no longer fits, so its tail is
+    // smaller than a tile, while the final extent of each writer may leave
+    // up to a whole extent unused. Below the lowest final extent the small
+    // tails are left in place. From it onward every extent slides down in
+    // address order onto the live bytes of the one before it, so that every
+    // final tail is reclaimed and the file ends at the last tile. The final
+    // extents were reserved last and lie near the end of the file, so only
+    // the top of it is rewritten; bytes only move toward the start of the
+    // file and each moves at most once.
+    auto& extents = registry.extents;
+    if (extents.empty()) return;
+    extents.sort([](const WriteExtent& a, const WriteExtent& b) {
+        return a.start < b.start;
+    });
+    struct Move {
+        Offset start;
+        Offset end;
+        Offset destination;
+    };
+    std::vector<Move> moves;
+    
+    // Positional writes move whole blocks (the final partial block of an
+    // extent was padded into its tail), and with pread / pwrite rather than
+    // through the mapping, so that finishing the file causes no writeback.
+    const Size alignment = file->backend == FILE_WRITE_MAPPED ? 1 : WriteStage::alignment;
+    const auto ALIGN     = [alignment](Offset __o) {
+        return (__o + alignment-1) & ~static_cast<Offset>(alignment-1);
+    };
+    Offset cursor  = extents.front().start;
+    bool   sliding = false;
+    for (auto& extent : extents) {
+        if (!sliding && extent.retired) {
+            cursor = extent.end;
+            continue;
+        }
+        sliding = true;
+        const Offset destination = ALIGN(cursor);
+        const Size   size        = ALIGN(extent.next) - extent.start;
+        if (destination < extent.start) {
+            auto result = move_file_range(file, FileMoveInfo {
+                .source         = extent.start,
+                .destination    = destination,
+                .size           = size,
+            }); if (result != IRIS_SUCCESS)
+                throw std::runtime_error(result.message);
+            moves.push_back(Move {extent.start, extent.next, destination});
+        }
+        cursor = std::max(cursor, destination + (extent.next - extent.start));
+    }
+    
+    // Relocate the tile entries (shared entries relocate identically). The
+    // moves are in address order and never chain, so each entry needs only
+    // the one move whose source holds it.
+    if (moves.size()) for (auto& layer : table.layers)
+        for (auto& entry : layer) {
+            auto move = std::upper_bound(moves.begin(), moves.end(), entry.offset,
+                                         [](Offset __o, const Move& __m) {
+                return __o < __m.start;
+            });
+            if (move == moves.begin()) continue;
+            --move;
+            if (entry.offset < move->end)
+                entry.offset = entry.offset - move->start + move->destination;
+        }
+    offset.store(cursor);
+    extents.clear();
+}
+inline void RECORD_SHARED_TILE (EncoderTracker& tracker, const TileEntry& entry)
+{
+    tracker.shared.fetch_add(1, std::memory_order_relaxed);
+    tracker.shared_bytes.fetch_add(entry.size, std::memory_order_relaxed);
+}
+void STORE_ENCODED_TILE (const Context& ctx,
+                         const File& file,
+                         atomic_uint64& offset,
+                         EncoderTracker& tracker,
+                         TileEntry& entry,
+                         const Buffer& pixels,
+                         Format format,
+                         Encoding encoding,
+                         Buffer bytes)
+{
+    // Uniform (ex. blank glass) tiles are compressed and written once per
+    // color; every repeat references the bytes of the first.
+    uint32_t    uniform_key = 0;
+    const bool  uniform     = UNIFORM_TILE_KEY(pixels, format, uniform_key);
+    if (uniform) {
+        MutexLock __ (tracker.uniform.mutex);
+        auto stored = tracker.uniform.entries.find(uniform_key);
+        if (stored != tracker.uniform.entries.end()) {
+            entry = stored->second;
+            RECORD_SHARED_TILE(tracker, entry);
+            return;
+        }
+    }
+    
+    // Compressed streams are copied into the file before this returns, so
+    // each thread compresses into one reused buffer. It adopts any larger
+    // buffer a codec had to allocate in its place.
+    thread_local Buffer compressed = Create_strong_buffer(TILE_PIX_BYTES_RGBA);
+    if (!bytes) {
+        bytes = ctx->compress_tile({
+            .pixelArray             = pixels,
+            .optionalDestination    = compressed,
+            .format                 = format,
+            .encoding               = encoding,
+            .quality                = ctx->get_quality(),
+            .subsampling            = ctx->get_subsampling(),
+        });
+        if (!bytes) throw std::runtime_error("Failed to compress slide image data");
+        compressed = bytes;
+    }
+    
+    // Optionally share byte-identical streams (ex. repeated background at
+    // low zoom, padded edge tiles, or repeated pass-through source tiles)
+    const bool  deduplicate = ctx->get_tile_deduplication();
+    const auto  hash        = deduplicate ? HASH_TILE_BYTES(bytes) : 0;
+    if (deduplicate && FIND_HASHED_TILE(file, tracker.hashed, hash, bytes, entry)) {
+        RECORD_SHARED_TILE(tracker, entry);
+        return;
+    }
+    
+    entry.size      = U32_CAST(bytes->size());
+    auto& extent    = RESERVE_TILE_BYTES(file, offset, tracker, entry.size);
+    entry.offset    = extent.next;
+    extent.next    += entry.size;
+    const auto data = static_cast<const BYTE*>(bytes->data());
+    if (extent.stage.data) {
+        // Positional writes: stage the bytes and hold back the hash until
+        // they are written, so others never compare against a stale file.
+        if (deduplicate) extent.stage.hashes.emplace_back(hash, entry);
+        STAGE_TILE_BYTES(file, extent, tracker.hashed, data, entry.size);
+    } else {
+        // A concurrent extent reservation may remap the file while copying
+        // unless its address range is reserved (then the lock is deferred)
+        auto shared_write_lock = file->read_lock();
+        memcpy(file->ptr + entry.offset, data, entry.size);
+        extent.written.store(entry.offset + entry.size, std::memory_order_release);
+    }
+    
+    // Another thread may have stored the same color concurrently; the
+    // first registration wins and this copy is simply not shared.
+    if (uniform) {
+        MutexLock __ (tracker.uniform.mutex);
+        tracker.uniform.entries.emplace(uniform_key, entry);
+    }
+    if (deduplicate && !extent.stage.data)
+        REGISTER_HASHED_TILE(tracker.hashed, hash, entry);
+}
+// ~~~~~~~~~~~~~~~~~~~~~~~~ END TILE STORAGE ~~~~~~~~~~~~~~~~~~~~~~~ //
 inline static void ENCODE_SOURCE_PYRAMID (const Context ctx,
                                           const EncoderSource& src,
                                           const File file,
@@ -709,6 +1197,10 @@ inline static void ENCODE_SOURCE_PYRAMID (const Context ctx,
     auto& offset    = *_offset;
     auto& status    = *_status;
     
+    // Source tiles are stored before the next is read; reuse one
+    // pixel buffer for the whole pass rather than one per tile.
+    Buffer scratch          = Create_strong_buffer(TILE_PIX_BYTES_RGBA);
+    
     // Allocate a layer and tile index counter.
     uint32_t __LI           = 0;
     uint32_t __TI           = 0;
@@ -732,43 +1224,31 @@ inline static void ENCODE_SOURCE_PYRAMID (const Context ctx,
             //  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ //
             //  READ TILE STEP
             //  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ //
+            // Compressed source tiles are only copied as-is when they
+            // already match the output encoding; otherwise decode them.
             auto bytes           = GET_SOURCE_TILE (src, __LI, __TI);
-            if  (bytes == NULL) {
-                auto pixel_array = READ_SOURCE_TILE (ctx, src, __LI, __TI);
+            auto pixel_array     = Buffer();
+            if  (bytes && src.encoding != table.encoding) {
+                pixel_array      = ctx->decompress_tile({
+                    .compressed     = bytes,
+                    .optionalDestination = scratch,
+                    .desiredFormat  = FORMAT_R8G8B8A8,
+                    .encoding       = src.encoding,
+                });
+                bytes            = NULL;
+            }
+            if  (bytes == NULL && pixel_array == NULL) {
+                pixel_array      = READ_SOURCE_TILE (ctx, src, __LI, __TI, scratch);
                 if (!pixel_array) throw std::runtime_error
                     ("Failed to read slide image data");
-                bytes           = ctx->compress_tile({
-                    .pixelArray = pixel_array,
-                    .format     = src.format,
-                    .encoding   = table.encoding
-                });
             }
-            if (!bytes) throw std::runtime_error("Failed to compress slide image data");
             
             //  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ //
-            //  WRITE TO FILE STEP
+            //  COMPRESS AND WRITE TO FILE STEP
             //  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ //
-            auto& entry     = layer_table[__TI];
-            entry.size      = U32_CAST(bytes->size());
-            entry.offset    = offset.fetch_add(entry.size);
-            ReadLock shared_write_lock (file->resize);
             tile.status     = TILE_ENCODING;
-            if (entry.offset + entry.size > file->size) {
-                shared_write_lock.unlock();
-                WriteLock resize_lock (file->resize);
-                // Expand the file by 500 MB per expansion
-                // We will shrink it back down to size at the end.
-                auto result = resize_file(file, FileResizeInfo {
-                    .size = file->size + (size_t)5E8,
-                });
-                if (result != IRIS_SUCCESS)
-                    throw std::runtime_error("Failed to resize growing tile blocks");
-                resize_lock.unlock();
-                shared_write_lock.lock();
-            }
-            auto dst = file->ptr + entry.offset;
-            memcpy(dst, bytes->data(), entry.size);
-            shared_write_lock.unlock();
+            STORE_ENCODED_TILE (ctx, file, offset, tracker, layer_table[__TI],
+                                pixel_array, src.format, table.encoding, bytes);
             
             //  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ //
             //  RELEASE TILE STEP
@@ -967,9 +1447,11 @@ inline Metadata READ_METADATA (const EncoderSource& source, const Extent& extent
         case EncoderSource::ENCODER_SRC_DICOM:
             return READ_DICOM_METADATA(source,extent,anonymize);
         case EncoderSource::ENCODER_SRC_APERIO:
-            //TODO: APERIO READ METADATA
-            throw std::runtime_error
-            ("READ_METADATA failed as APERIO TIFF reads not yet built; Use openslide for the moment");
+            #if IRIS_INCLUDE_TIFF
+            return READ_SVS_METADATA(source,extent,anonymize);
+            #else
+            throw std::runtime_error("libtiff linkage was NOT compiled into this binary. Aperio SVS files may only be read through OpenSlide.");
+            #endif
     } throw std::runtime_error
     ("READ_METADATA due to invalid source type value ("+std::to_string(source.sourceType)+")");
 }
@@ -1038,8 +1520,18 @@ inline Offset STORE_ASSOCIATED_IMAGES (const Context& ctx,
                     std::cout << "This implementation has not";
                     break;
                 case EncoderSource::ENCODER_SRC_APERIO:
-                    //TODO: APERIO READ METADATA
-                    throw std::runtime_error("READ_METADATA failed as APERIO TIFF reads not yet built; Use openslide for the moment");
+                    #if IRIS_INCLUDE_TIFF
+                    info    = get_svs_associated_image_info(source.svsFile, label);
+                    bytes   = ctx->compress_image(CompressImageInfo{
+                        .pixelArray = read_svs_associated_image(source.svsFile, info),
+                        .width      = info.width,
+                        .height     = info.height,
+                        .format     = info.sourceFormat,
+                        .encoding   = info.encoding,
+                        .quality    = QUALITY_DEFAULT
+                    });
+                    #endif
+                    break;
             }
             if (bytes->size() == 0) throw std::runtime_error
                 ("no bytes given for image buffer byte size");
@@ -1202,6 +1694,14 @@ inline void RESET_TRACKER (EncoderTracker &_tracker, const File &file, const Ext
     _tracker.dst_path   = file->get_path();
     _tracker.completed  = 0;
     _tracker.total      = 0;
+    _tracker.uniform.entries.clear();
+    for (auto& shard : _tracker.hashed.shards)
+        shard.entries.clear();
+    _tracker.shared         = 0;
+    _tracker.shared_bytes   = 0;
+    _tracker.interrupted    = false;
+    _tracker.writes.extents.clear();
+    _tracker.writes.epoch++;
     _tracker.layers     = EncoderTracker::Layers(extent.layers.size());
     for (auto __li = 0; __li < _tracker.layers.size(); ++__li) {
         auto& __le              = extent.layers[__li];
@@ -1211,6 +1711,339 @@ inline void RESET_TRACKER (EncoderTracker &_tracker, const File &file, const Ext
     }
 }
 
+// ~~~~~~~~~~~~~~~~~~~~~~~~ CHECKPOINT JOURNAL ~~~~~~~~~~~~~~~~~~~~~~~ //
+inline std::filesystem::path CHECKPOINT_JOURNAL_PATH (const std::filesystem::path& dst_file_path)
+{
+    // One journal per destination, beside the temporary cache files, so a
+    // later encode of the same output finds it without any other state.
+    uint64_t key = 0xCBF29CE484222325ULL; // FNV-1a
+    for (const char c : dst_file_path.string())
+        key = (key ^ static_cast<uint8_t>(c)) * 0x100000001B3ULL;
+    char name[40];
+    snprintf(name, sizeof(name), "IrisCodecJournal_%016llx",
+             static_cast<unsigned long long>(key));
+    return std::filesystem::temp_directory_path() / name;
+}
+inline EncoderCheckpoint CHECKPOINT_IDENTITY (const std::string& source,
+                                              const std::filesystem::path& destination,
+                                              const Context& ctx,
+                                              Encoding encoding,
+                                              bool derive,
+                                              const EncoderDerivation& derivation,
+                                              const Extent& extent)
+{
+    // Sources may be directories (ex. DICOM); those are identified by path
+    // and modification time alone.
+    std::error_code error;
+    EncoderCheckpoint identity;
+    identity.source         = source;
+    identity.destination    = destination.string();
+    const auto size         = std::filesystem::file_size(source, error);
+    identity.sourceSize     = error ? 0 : size;
+    const auto modified     = std::filesystem::last_write_time(source, error);
+    identity.sourceModified = error ? 0 : static_cast<int64_t>
+                              (modified.time_since_epoch().count());
+    identity.encoding       = static_cast<uint32_t>(encoding);
+    identity.derivation     = derive ? static_cast<uint32_t>(derivation.layers) |
+                              static_cast<uint32_t>(derivation.method) << 8 : 0;
+    identity.quality        = static_cast<uint32_t>(ctx->get_quality());
+    identity.subsampling    = static_cast<uint32_t>(ctx->get_subsampling());
+    identity.jpegOptimize   = ctx->get_jpeg_optimize() ? 1 : 0;
+    identity.avifSpeed      = static_cast<uint32_t>(ctx->get_avif_options().speed);
+    identity.avifAutoTiling = ctx->get_avif_options().autoTiling ? 1 : 0;
+    identity.deduplicate    = ctx->get_tile_deduplication() ? 1 : 0;
+    for (auto& layer : extent.layers)
+        identity.layers.emplace_back(layer.xTiles, layer.yTiles);
+    return identity;
+}
+inline bool MATCHES_CHECKPOINT (const EncoderCheckpoint& checkpoint, const EncoderCheckpoint& identity)
+{
+    return  checkpoint.source           == identity.source          &&
+            checkpoint.destination      == identity.destination     &&
+            checkpoint.sourceSize       == identity.sourceSize      &&
+            checkpoint.sourceModified   == identity.sourceModified  &&
+            checkpoint.encoding         == identity.encoding        &&
+            checkpoint.derivation       == identity.derivation      &&
+            checkpoint.quality          == identity.quality         &&
+            checkpoint.subsampling      == identity.subsampling     &&
+            checkpoint.jpegOptimize     == identity.jpegOptimize    &&
+            checkpoint.avifSpeed        == identity.avifSpeed       &&
+            checkpoint.avifAutoTiling   == identity.avifAutoTiling  &&
+            checkpoint.deduplicate      == identity.deduplicate     &&
+            checkpoint.layers           == identity.layers;
+}
+template <typename T>
+inline void JOURNAL_PUT (std::vector<BYTE>& journal, const T& value)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Journal values must be trivially copyable");
+    const auto bytes = reinterpret_cast<const BYTE*>(&value);
+    journal.insert(journal.end(), bytes, bytes + sizeof(T));
+}
+inline void JOURNAL_PUT (std::vector<BYTE>& journal, const std::string& value)
+{
+    JOURNAL_PUT(journal, static_cast<uint32_t>(value.size()));
+    journal.insert(journal.end(), value.begin(), value.end());
+}
+template <typename T>
+inline void JOURNAL_GET (const BYTE*& cursor, const BYTE* end, T& value)
+{
+    if (cursor + sizeof(T) > end) throw std::runtime_error
+        ("Encoder checkpoint journal is truncated");
+    memcpy(&value, cursor, sizeof(T));
+    cursor += sizeof(T);
+}
+inline void JOURNAL_GET (const BYTE*& cursor, const BYTE* end, std::string& value)
+{
+    uint32_t size = 0;
+    JOURNAL_GET(cursor, end, size);
+    if (cursor + size > end) throw std::runtime_error
+        ("Encoder checkpoint journal is truncated");
+    value.assign(reinterpret_cast<const char*>(cursor), size);
+    cursor += size;
+}
+constexpr char CHECKPOINT_MAGIC[8] = {'I','R','I','S','C','K','P','T'};
+inline void STORE_CHECKPOINT_JOURNAL (const std::filesystem::path& journal_path,
+                                      const EncoderCheckpoint& checkpoint)
+{
+    std::vector<BYTE> journal (CHECKPOINT_MAGIC, CHECKPOINT_MAGIC + sizeof(CHECKPOINT_MAGIC));
+    JOURNAL_PUT(journal, EncoderCheckpoint::version);
+    JOURNAL_PUT(journal, checkpoint.source);
+    JOURNAL_PUT(journal, checkpoint.destination);
+    JOURNAL_PUT(journal, checkpoint.partial);
+    JOURNAL_PUT(journal, checkpoint.sourceSize);
+    JOURNAL_PUT(journal, checkpoint.sourceModified);
+    JOURNAL_PUT(journal, checkpoint.encoding);
+    JOURNAL_PUT(journal, checkpoint.derivation);
+    JOURNAL_PUT(journal, checkpoint.quality);
+    JOURNAL_PUT(journal, checkpoint.subsampling);
+    JOURNAL_PUT(journal, checkpoint.jpegOptimize);
+    JOURNAL_PUT(journal, checkpoint.avifSpeed);
+    JOURNAL_PUT(journal, checkpoint.avifAutoTiling);
+    JOURNAL_PUT(journal, checkpoint.deduplicate);
+    JOURNAL_PUT(journal, static_cast<uint32_t>(checkpoint.layers.size()));
+    for (auto& layer : checkpoint.layers) {
+        JOURNAL_PUT(journal, layer.first);
+        JOURNAL_PUT(journal, layer.second);
+    }
+    JOURNAL_PUT(journal, static_cast<uint32_t>(checkpoint.spans.size()));
+    for (auto& span : checkpoint.spans) {
+        JOURNAL_PUT(journal, span.start);
+        JOURNAL_PUT(journal, span.end);
+        JOURNAL_PUT(journal, span.written);
+    }
+    JOURNAL_PUT(journal, static_cast<uint32_t>(checkpoint.tiles.size()));
+    for (auto& tile : checkpoint.tiles) {
+        JOURNAL_PUT(journal, tile.layer);
+        JOURNAL_PUT(journal, tile.index);
+        JOURNAL_PUT(journal, static_cast<uint64_t>(tile.entry.offset));
+        JOURNAL_PUT(journal, static_cast<uint32_t>(tile.entry.size));
+    }
+    
+    // Write the journal beside the current one, flush it, and rename it
+    // over the current one so that a failure never leaves a torn journal.
+    auto next_path = journal_path;
+    next_path += ".next";
+    {
+        auto file = create_file(FileCreateInfo {
+            .filePath       = next_path.string(),
+            .initial_size   = journal.size(),
+        }); if (file == nullptr) throw std::runtime_error
+            ("Failed to create the encoder checkpoint journal " + next_path.string());
+        memcpy(file->ptr, journal.data(), journal.size());
+        auto result = sync_file(file);
+        if (result != IRIS_SUCCESS)
+            throw std::runtime_error(result.message);
+        result = rename_file(file, journal_path.string());
+        if (result != IRIS_SUCCESS)
+            throw std::runtime_error(result.message);
+    }
+}
+inline bool READ_CHECKPOINT_JOURNAL (const std::filesystem::path& journal_path,
+                                     EncoderCheckpoint& checkpoint)
+{
+    std::error_code error;
+    if (std::filesystem::exists(journal_path, error) == false) return false;
+    auto file = open_file(FileOpenInfo {
+        .filePath   = journal_path.string(),
+    }); if (file == nullptr) return false;
+    try {
+        const BYTE* cursor  = file->ptr;
+        const BYTE* end     = file->ptr + file->size;
+        char     magic[sizeof(CHECKPOINT_MAGIC)];
+        uint32_t version    = 0;
+        JOURNAL_GET(cursor, end, magic);
+        JOURNAL_GET(cursor, end, version);
+        if (memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) ||
+            version != EncoderCheckpoint::version) return false;
+        JOURNAL_GET(cursor, end, checkpoint.source);
+        JOURNAL_GET(cursor, end, checkpoint.destination);
+        JOURNAL_GET(cursor, end, checkpoint.partial);
+        JOURNAL_GET(cursor, end, checkpoint.sourceSize);
+        JOURNAL_GET(cursor, end, checkpoint.sourceModified);
+        JOURNAL_GET(cursor, end, checkpoint.encoding);
+        JOURNAL_GET(cursor, end, checkpoint.derivation);
+        JOURNAL_GET(cursor, end, checkpoint.quality);
+        JOURNAL_GET(cursor, end, checkpoint.subsampling);
+        JOURNAL_GET(cursor, end, checkpoint.jpegOptimize);
+        JOURNAL_GET(cursor, end, checkpoint.avifSpeed);
+        JOURNAL_GET(cursor, end, checkpoint.avifAutoTiling);
+        JOURNAL_GET(cursor, end, checkpoint.deduplicate);
+        uint32_t count = 0;
+        JOURNAL_GET(cursor, end, count);
+        checkpoint.layers.resize(count);
+        for (auto& layer : checkpoint.layers) {
+            JOURNAL_GET(cursor, end, layer.first);
+            JOURNAL_GET(cursor, end, layer.second);
+        }
+        JOURNAL_GET(cursor, end, count);
+        checkpoint.spans.resize(count);
+        for (auto& span : checkpoint.spans) {
+            JOURNAL_GET(cursor, end, span.start);
+            JOURNAL_GET(cursor, end, span.end);
+            JOURNAL_GET(cursor, end, span.written);
+        }
+        JOURNAL_GET(cursor, end, count);
+        checkpoint.tiles.resize(count);
+        for (auto& tile : checkpoint.tiles) {
+            uint64_t offset = 0;
+            uint32_t size   = 0;
+            JOURNAL_GET(cursor, end, tile.layer);
+            JOURNAL_GET(cursor, end, tile.index);
+            JOURNAL_GET(cursor, end, offset);
+            JOURNAL_GET(cursor, end, size);
+            tile.entry.offset   = offset;
+            tile.entry.size     = size;
+        }
+    } catch (std::runtime_error&) {
+        return false;
+    }
+    return true;
+}
+inline void DISCARD_CHECKPOINT (const std::filesystem::path& journal_path)
+{
+    std::error_code error;
+    std::filesystem::remove(journal_path, error);
+}
+inline bool VALIDATE_CHECKPOINT (const EncoderCheckpoint& checkpoint, const File& file)
+{
+    // Journaled tiles must be unique and in order, each within the durable
+    // bytes of a span, and every span within the partial file.
+    for (auto& span : checkpoint.spans)
+        if (span.start > span.written || span.written > span.end ||
+            span.end > file->size) return false;
+    for (auto tile = checkpoint.tiles.begin(); tile != checkpoint.tiles.end(); ++tile)
+        if (tile != checkpoint.tiles.begin() &&
+            std::tie(tile->layer, tile->index) <= std::tie(std::prev(tile)->layer, std::prev(tile)->index))
+            return false;
+    for (auto& tile : checkpoint.tiles) {
+        if (tile.layer >= checkpoint.layers.size()) return false;
+        auto& layer = checkpoint.layers[tile.layer];
+        if (tile.index >= static_cast<uint64_t>(layer.first) * layer.second) return false;
+        auto durable = std::any_of(checkpoint.spans.begin(), checkpoint.spans.end(),
+                                   [&tile](const EncoderCheckpoint::Span& __s) {
+            return tile.entry.offset >= __s.start &&
+                   tile.entry.offset + tile.entry.size <= __s.written;
+        });
+        if (!durable || tile.entry.size == 0) return false;
+    }
+    return true;
+}
+inline void STORE_CHECKPOINT (const File& file,
+                              EncoderTracker& tracker,
+                              const Abstraction::TileTable& table,
+                              const EncoderCheckpoint::Tiles& restored,
+                              EncoderCheckpoint& checkpoint,
+                              const std::filesystem::path& journal_path)
+{
+    // Take how far each extent is within the file BEFORE looking at the
+    // tiles; a tile completed since may then only be left out, never
+    // journaled ahead of its bytes.
+    auto& spans = checkpoint.spans;
+    spans.clear();
+    {
+        MutexLock __ (tracker.writes.mutex);
+        for (auto& extent : tracker.writes.extents)
+            spans.push_back(EncoderCheckpoint::Span {
+                extent.start, extent.end,
+                extent.written.load(std::memory_order_acquire)
+            });
+    }
+    std::sort(spans.begin(), spans.end(), [](const EncoderCheckpoint::Span& a,
+                                             const EncoderCheckpoint::Span& b) {
+        return a.start < b.start;
+    });
+    
+    // Restored tiles are carried over whatever their status; derived ones
+    // are not complete until the derivation passes through them again.
+    // Shared (uniform or deduplicated) entries reference bytes of another
+    // tile and are durable if those bytes are.
+    checkpoint.tiles.clear();
+    auto restored_tile = restored.begin();
+    for (uint32_t __LI = 0; __LI < tracker.layers.size(); ++__LI)
+        for (uint32_t __TI = 0; __TI < tracker.layers[__LI].size(); ++__TI) {
+            if (restored_tile != restored.end() &&
+                restored_tile->layer == __LI && restored_tile->index == __TI) {
+                checkpoint.tiles.push_back(*restored_tile++);
+                continue;
+            }
+            if (tracker.layers[__LI][__TI].status.load() != TILE_COMPLETE) continue;
+            const auto& entry = table.layers[__LI][__TI];
+            auto span = std::upper_bound(spans.begin(), spans.end(), entry.offset,
+                                         [](Offset __o, const EncoderCheckpoint::Span& __s) {
+                return __o < __s.start;
+            });
+            if (span == spans.begin() ||
+                entry.offset + entry.size > std::prev(span)->written) continue;
+            checkpoint.tiles.push_back(EncoderCheckpoint::Tile {__LI, __TI, entry});
+        }
+    
+    // The journal may only reference bytes that would survive a crash
+    auto result = sync_file(file);
+    if (result != IRIS_SUCCESS)
+        throw std::runtime_error(result.message);
+    STORE_CHECKPOINT_JOURNAL(journal_path, checkpoint);
+}
+inline Offset RESTORE_CHECKPOINT (const EncoderCheckpoint& checkpoint,
+                                  EncoderTracker& tracker,
+                                  Abstraction::TileTable& table,
+                                  uint32_t derive_shift)
+{
+    // The journaled extents are restored as final (non-retired) write
+    // extents, ending at their last durable tile, so that compaction
+    // reclaims their unused tails; restored as retired, those tails would
+    // stay in the file. No writer packs into them again: tiles written after
+    // the last checkpoint are simply encoded again into new extents.
+    Offset end = 0;
+    for (auto& span : checkpoint.spans) {
+        tracker.writes.extents.emplace_back(span.start, span.end, span.written);
+        end = std::max(end, span.end);
+    }
+    // Copied source tiles are complete once restored. A derived tile is
+    // only complete if the lower resolution tile it is downsampled into is
+    // as well (journaled tiles are in layer order, lowest resolution first);
+    // then no tile above it in the pyramid needs its pixels, and a complete
+    // source tile is never read. Any other journaled tile must still pass
+    // through the derivation to build the layers beneath it, but its
+    // encoding and write are skipped.
+    const auto& layers = table.extent.layers;
+    for (auto& tile : checkpoint.tiles) {
+        auto& tracked = tracker.layers[tile.layer][tile.index];
+        table.layers[tile.layer][tile.index] = tile.entry;
+        tracked.restored = true;
+        if (derive_shift && tile.layer > 0) {
+            const auto x_tiles  = layers[tile.layer].xTiles;
+            const auto parent   = ((tile.index / x_tiles) >> derive_shift) * layers[tile.layer-1].xTiles +
+                                  ((tile.index % x_tiles) >> derive_shift);
+            if (tracker.layers[tile.layer-1][parent].status.load() != TILE_COMPLETE)
+                continue;
+        }
+        tracked.status.store(TILE_COMPLETE);
+        tracker.completed++;
+    }
+    return end;
+}
+// ~~~~~~~~~~~~~~~~~~~~~~ END CHECKPOINT JOURNAL ~~~~~~~~~~~~~~~~~~~~~ //
+
 // ~~~~~~~~~~~~~~~~~~~~~~~~~ TILE DERIVATION ~~~~~~~~~~~~~~~~~~~~~~~~ //
 Iris::Extent GENERATE_DERIVED_EXTENT (const EncoderDerivation &_derivation,
                                       const EncoderSource &source);
@@ -1270,27 +2103,80 @@ Result __INTERNAL__Encoder::dispatch_encoder()
         std::cout       << "[WARNING] Destination file " << dst_file_path
                         << " already exists. Overwriting...\n";
     
+    // This is the extent of the output slide file
+    Iris::Extent extent;
+    if (_derive /* If we are deriving all lower-res layers */)
+        extent  = GENERATE_DERIVED_EXTENT (_derivation, source);
+    // Otherwise just copy the source extent
+    else extent = source.extent;
+    
+    // If checkpointing, look for the journal of an interrupted encode of
+    // this same slide and, if it still matches, resume its partial file.
+    File file = NULL;
+    std::filesystem::path journal_path;
+    EncoderCheckpoint checkpoint;
+    if (_checkpoints.enabled) {
+        journal_path  = CHECKPOINT_JOURNAL_PATH (dst_file_path);
+        auto identity = CHECKPOINT_IDENTITY (_srcPath, dst_file_path, _context,
+                                             _encoding, _derive, _derivation, extent);
+        if (READ_CHECKPOINT_JOURNAL (journal_path, checkpoint)) {
+            if (MATCHES_CHECKPOINT (checkpoint, identity) &&
+                std::filesystem::exists(checkpoint.partial))
+                file = open_file(FileOpenInfo {
+                    .filePath       = checkpoint.partial,
+                    .writeAccess    = true,
+                });
+            if (file && VALIDATE_CHECKPOINT (checkpoint, file) == false)
+                file = NULL;
+            if (file) std::cout
+                << "Resuming encoding from checkpoint with "
+                << checkpoint.tiles.size() << " tiles already encoded\n";
+            else {
+                std::cout   << "[WARNING] Discarding the checkpoint of an earlier encode of "
+                            << dst_file_path << " that no longer matches. Encoding from the beginning.\n";
+                std::error_code error;
+                std::filesystem::remove(checkpoint.partial, error);
+                DISCARD_CHECKPOINT (journal_path);
+            }
+        }
+        if (file == nullptr) checkpoint = identity;
+    }
+    
     // Generate a temporary cache file.
     // We do not write directly to the output file path. It's better
     // practice to open a temp file within the temp_dir and write to that
     // (in case it fails we don't keep an artifiact).
     // We then rename it to the output file path once encoding is successful.
-    auto file = create_cache_file({
+    if (file == nullptr) file = create_cache_file({
         .unlink     = false,    // Maintain OS link to file so it can be renamed
         .context    = _context, // Provide own Codec context
     }); if (file == nullptr) throw std::runtime_error
         ("[ERROR] Could not create a temporary slide file for encoding");
-    
-    // This is the extent of the output slide file
-    Iris::Extent extent;
-    if (_derive /* If we are deriving all lower-res layers */)
-        extent  = GENERATE_DERIVED_EXTENT (_derivation, source);
-    // Otherwise just copy the source extent
-    else extent = source.extent;
+    checkpoint.partial = file->get_path();
     
     // Reset the tracker
     RESET_TRACKER (_tracker, file, extent);
     
+    // Reserve address space for the file to grow into in place so that
+    // tile writers never wait on a remap. The estimate allows a generous
+    // byte per pixel with 4x headroom; the reservation commits neither
+    // memory nor disk. Without it, the file is simply remapped as it grows.
+    const size_t estimate = static_cast<size_t>(_tracker.total) * TILE_PIX_AREA;
+    auto reserved = reserve_file(file, FileReserveInfo {
+        .size       = std::max<size_t>(estimate * 4, 64ULL << 30),
+    }); if (reserved != IRIS_SUCCESS)
+        std::cout   << "[WARNING] " << reserved.message
+                    << ". The encoded file will be remapped as it grows.\n";
+
+    // Optionally write tiles with positional writes rather than copying them
+    // into the mapping, which is still used to compact and finish the file.
+    if (_writeBackend != FILE_WRITE_MAPPED) {
+        auto selected = set_file_write_backend(file, _writeBackend);
+        if (selected != IRIS_SUCCESS)
+            std::cout   << "[WARNING] " << selected.message
+                        << ". Tiles will be written through the file mapping.\n";
+    }
+    
     // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
     // BEGIN OUR ASYNCHRONOUS STEPS; This thread will return immediately
     // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -1312,7 +2198,8 @@ Result __INTERNAL__Encoder::dispatch_encoder()
             _threads    = Threads(_concurrency+1);
             break;
     }
-    _threads[0] = std::thread {[this, file, source, extent, dst_file_path](){
+    _threads[0] = std::thread {[this, file, source, extent, dst_file_path,
+                                journal_path, checkpoint]() mutable {
         
         // ~~~ We are now on the separate asynchronous main thread ~~~
         
@@ -1334,7 +2221,22 @@ Result __INTERNAL__Encoder::dispatch_encoder()
         }
         
         // Create the file byte offset tracker and reserve space for the footer
-        atomic_uint64 offset = FILE_HEADER::header_size;
+        // (positional writes are made in whole blocks; begin block aligned)
+        atomic_uint64 offset = file->backend == FILE_WRITE_MAPPED ?
+        FILE_HEADER::header_size :
+        (FILE_HEADER::header_size + WriteStage::alignment-1) & ~(WriteStage::alignment-1);
+        
+        // Restore the tiles journaled by an interrupted encode and continue
+        // writing beyond the extents that hold them
+        const auto restored = checkpoint.tiles;
+        if (checkpoint.spans.size()) {
+            const uint32_t derive_shift = _derive == false ? 0 :
+            _derivation.layers == EncoderDerivation::ENCODER_DERIVE_4X_LAYERS ? 2 : 1;
+            Offset end = RESTORE_CHECKPOINT (checkpoint, _tracker, tile_table, derive_shift);
+            if (file->backend != FILE_WRITE_MAPPED)
+                end = (end + WriteStage::alignment-1) & ~(WriteStage::alignment-1);
+            offset = std::max<Offset>(offset, end);
+        }
         
         // Create the downsample information struct
         // WARNING: THIS MUST PERSIST UNTIL ALL ASYNC THREADS ARE COMPLETE
@@ -1377,17 +2279,66 @@ Result __INTERNAL__Encoder::dispatch_encoder()
                                    &_status, l, y, x));
                     }
                 };
+        
+        // Periodically journal the tiles durably written while encoding
+        std::atomic_bool encoded {false};
+        std::thread checkpointer;
+        if (_checkpoints.enabled) checkpointer = std::thread {[&](){
+            const auto interval = std::chrono::seconds(_checkpoints.interval);
+            auto due = std::chrono::steady_clock::now() + interval;
+            while (encoded == false && _status == ENCODER_ACTIVE) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                if (std::chrono::steady_clock::now() < due) continue;
+                try {
+                    STORE_CHECKPOINT (file, _tracker, tile_table, restored,
+                                      checkpoint, journal_path);
+                } catch (std::runtime_error& e) {
+                    std::cout << "[WARNING] Failed to checkpoint encoding: " << e.what() << "\n";
+                }
+                due = std::chrono::steady_clock::now() + interval;
+            }
+        }};
+        
         for (auto thread_idx = 1; thread_idx < _threads.size(); ++thread_idx)
             if (_threads[thread_idx].joinable()) _threads[thread_idx].join();
         // Await asynchronous thread pool if encoding tasks were delegated
         if (queue) queue->wait_until_complete();
         // It is NOW safe to destroy the downsample_info struct
+        encoded = true;
+        if (checkpointer.joinable()) checkpointer.join();
         // ~~~~~~~~~~~~~~~~~~~~~ END TILE ENCODING ~~~~~~~~~~~~~~~~~~~~~~~~~
         
-        // If any thread has inactivated the encoder, exit
-        if (_status!= ENCODER_ACTIVE) { _status.notify_all(); goto ENCODING_FAILED;}
+        // If any thread has inactivated the encoder, exit. When checkpointing
+        // an interrupted encode, journal the tiles written so far and keep the
+        // partial file instead. A failed encode (ex. a corrupt source tile)
+        // would only resume into the same failure; it is discarded.
+        if (_status!= ENCODER_ACTIVE) {
+            if (_checkpoints.enabled &&
+                (_tracker.interrupted || _status == ENCODER_SHUTDOWN)) {
+                try {
+                    FLUSH_WRITE_EXTENTS (file, _tracker);
+                    STORE_CHECKPOINT    (file, _tracker, tile_table, restored,
+                                         checkpoint, journal_path);
+                } catch (std::runtime_error& e) {
+                    std::cout << "[WARNING] Failed to checkpoint encoding: " << e.what() << "\n";
+                }
+                // An earlier journal remains valid as journaled bytes are
+                // never rewritten before the tiles are compacted
+                std::error_code error;
+                if (std::filesystem::exists(journal_path, error)) {
+                    std::cout   << "[WARNING] Encoding stopped. Encode " << _srcPath
+                                << " to the same destination to resume from its checkpoint.\n";
+                    _status.notify_all();
+                    return;
+                }
+            }
+            _status.notify_all(); goto ENCODING_FAILED;
+        }
         // This is our exit routine. Delete the created file
-        if (false) { ENCODING_FAILED: IrisCodec::delete_file(file); return;}
+        if (false) { ENCODING_FAILED:
+            if (_checkpoints.enabled) DISCARD_CHECKPOINT (journal_path);
+            IrisCodec::delete_file(file); return;
+        }
         
         // ~~~~~~~~~~~~~~~~~~~~~ BEGIN VALIDATION  ~~~~~~~~~~~~~~~~~~~~~~~~~
         Offset tile_table_offset = NULL_OFFSET;
@@ -1395,6 +2346,14 @@ Result __INTERNAL__Encoder::dispatch_encoder()
             // Check the tiles to ensure they were properly written to file
             VALIDATE_TILE_WRITES (_tracker, tile_table);
             
+            // Compaction moves the tiles; the journal no longer applies
+            if (_checkpoints.enabled) DISCARD_CHECKPOINT (journal_path);
+            
+            // Write out any staged tiles and then reclaim the unused
+            // tails of the per-thread write extents
+            FLUSH_WRITE_EXTENTS (file, _tracker);
+            COMPACT_WRITE_EXTENTS (file, _tracker.writes, tile_table, offset);
+            
             // Write the tile table and return the offset
             tile_table_offset = STORE_TILE_TABLE (file, tile_table, offset);
             
@@ -1480,6 +2439,7 @@ Result __INTERNAL__Encoder::interrupt_encoder()
 {
     switch (_status) {
         case ENCODER_ACTIVE: {
+            _tracker.interrupted.store(true);
             _status.store(ENCODER_ERROR);
             MutexLock __ (_tracker.error_msg_mutex);
             _tracker.error_msg += "Encoder manually interrupted\n";
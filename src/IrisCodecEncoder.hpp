@@ -24,6 +24,8 @@ class __INTERNAL__Encoder {
     std::string                     _dstPath;
     bool                            _anonymize;
     Encoding                        _encoding;
+    FileWriteBackend                _writeBackend   = FILE_WRITE_MAPPED;
+    EncoderCheckpointOptions        _checkpoints;
     EncoderDerivation               _derivation;
     Threads                         _threads;
     EncoderTracker                  _tracker;
@@ -39,12 +41,16 @@ public:
     std::string get_src_path        () const;
     std::string get_dst_path        () const;
     Encoding    get_encoding        () const;
+    FileWriteBackend get_write_backend () const;
     Result  get_encoder_progress    (EncoderProgress&) const;
+    Result  get_dedup_stats         (EncoderDedupStats&) const;
     
     void    set_src_path            (const std::string& source);
     void    set_src_cache           (const Cache& source);
     void    set_dst_path            (const std::string& destination);
     void    set_encoding            (Encoding desired_encoding);
+    void    set_write_backend       (FileWriteBackend backend);
+    void    set_checkpoints         (const EncoderCheckpointOptions& options);
     Result  reset_encoder           ();
     Result  dispatch_encoder        ();
     Result  interrupt_encoder       ();
@@ -8,6 +8,7 @@
 #include <assert.h>
 #include <iostream>
 #include <filesystem>
+#include <algorithm>
 #include <system_error>
 #include "IrisCodecPriv.hpp"
 namespace IrisCodec {
@@ -15,10 +16,19 @@ inline void         GENERATE_TEMP_FILE          (const File& file, bool unlink);
 inline size_t       GET_FILE_SIZE               (const File& file);
 inline void         PERFORM_FILE_MAPPING        (const File& file);
 inline size_t       RESIZE_FILE                 (const File& file, size_t bytes);
+inline void         RESERVE_ADDRESS_RANGE       (const File& file, size_t bytes);
 inline void         RENAME_FILE                 (const File& file, const std::string& path);
 inline void         DELETE_FILE                 (const File& file);
 inline bool         LOCK_FILE                   (const File& file, bool exclusive, bool wait);
 inline void         UNLOCK_FILE                 (const File& file);
+inline void         ADVISE_FILE_RANGE           (const File& file, Offset offset, Size bytes, FileAdvice);
+inline void         CREATE_FILE_IMAGE           (const File& file);
+inline size_t       READ_FILE_RANGE             (const File& file, Offset offset, BYTE* data, Size bytes);
+inline size_t       READ_FILE_BLOCKS            (const File& file, Offset offset, Buffer* blocks, size_t count);
+inline void         SET_WRITE_BACKEND           (const File& file, FileWriteBackend);
+inline void         WRITE_FILE_RANGE            (const File& file, Offset offset, const BYTE* data, Size bytes);
+inline void         SYNC_FILE                   (const File& file);
+inline void         MOVE_FILE_RANGE             (const File& file, Offset source, Offset destination, Size bytes);
 
 // MARK: - WINDOWS FILE IO Implementations
 #if _WIN32
@@ -119,6 +129,8 @@ inline void PERFORM_FILE_MAPPING (File& file) {
     if (file->ptr == NULL)
         throw std::system_error(errno, std::generic_category(),
             "failed create mapped file view.");
+
+    // File mapping options are hints; views are mapped without them here.
 }
 inline static void UNMAP_FILE(HANDLE& map, BYTE*& ptr) {
     if (ptr == nullptr) return;
@@ -195,6 +207,54 @@ inline size_t RESIZE_FILE (const File& file, size_t bytes) {
     size = bytes;
     return bytes;
 }
+inline void RESERVE_ADDRESS_RANGE (const File& file, size_t bytes)
+{
+    // Views of a file mapping object cannot be extended in place on Windows;
+    // files continue to be remapped under the exclusive resize lock.
+}
+inline void CREATE_FILE_IMAGE (const File& file)
+{
+    throw std::runtime_error
+        ("Block cached file reads are not yet implemented on Windows");
+}
+inline size_t READ_FILE_RANGE (const File& file, Offset offset, BYTE* data, Size bytes)
+{
+    throw std::runtime_error
+        ("Block cached file reads are not yet implemented on Windows");
+}
+inline size_t READ_FILE_BLOCKS (const File& file, Offset offset, Buffer* blocks, size_t count)
+{
+    throw std::runtime_error
+        ("Block cached file reads are not yet implemented on Windows");
+}
+inline void SET_WRITE_BACKEND (const File& file, FileWriteBackend backend)
+{
+    if (backend != FILE_WRITE_MAPPED) throw std::runtime_error
+        ("Positional file writes are not yet implemented on Windows");
+    file->backend = backend;
+}
+inline void WRITE_FILE_RANGE (const File& file, Offset offset, const BYTE* data, Size bytes)
+{
+    auto shared_write_lock = file->read_lock();
+    memcpy(file->ptr + offset, data, bytes);
+}
+inline void MOVE_FILE_RANGE (const File& file, Offset source, Offset destination, Size bytes)
+{
+    // Only the mapped write backend is available on Windows
+    auto shared_write_lock = file->read_lock();
+    memmove(file->ptr + destination, file->ptr + source, bytes);
+}
+inline void SYNC_FILE (const File& file)
+{
+    auto shared_write_lock = file->read_lock();
+    if (FlushViewOfFile(file->ptr, file->size) == FALSE)
+        throw std::system_error(errno, std::generic_category(),
+            "failed to flush the mapped file view");
+    HANDLE handle = (HANDLE)_get_osfhandle(_fileno(file->handle));
+    if (FlushFileBuffers(handle) == FALSE)
+        throw std::system_error(errno, std::generic_category(),
+            "failed to flush the file buffers");
+}
 inline void RENAME_FILE (const File& file, const std::string& path)
 {
     if (rename(file->path.c_str(), path.c_str()) == -1)
@@ -247,13 +307,41 @@ inline void UNLOCK_FILE(File& file)
         throw std::system_error( errno, std::generic_category(),
             "Failed to unlock a locked file.");
 }
+inline void ADVISE_FILE_RANGE (const File& file, Offset offset, Size bytes, FileAdvice advice)
+{
+    switch (advice) {
+        case FILE_ADVICE_WILL_NEED: {
+            WIN32_MEMORY_RANGE_ENTRY range {
+                .VirtualAddress = file->ptr + offset,
+                .NumberOfBytes  = static_cast<SIZE_T>(bytes)
+            };
+            // Prefetching is purely advisory; failure is not an error
+            PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+            break;
+        }
+        case FILE_ADVICE_DONT_NEED:
+            // Unlocking pages that are not locked removes them from the
+            // process working set without discarding their contents.
+            VirtualUnlock(file->ptr + offset, static_cast<SIZE_T>(bytes));
+            break;
+    }
+}
 #else
 // MARK: - POSIX COMPLIENT IMPLEMENTATIONS
 #include <sys/file.h>
 #include <sys/mman.h>
 #include <sys/fcntl.h>
+#include <sys/uio.h>
+#include <climits>
 #include <unistd.h>
+#if __linux__
+#include <fcntl.h>
+#endif
 const size_t page_size = getpagesize();
+inline size_t PAGE_CEIL (size_t bytes)
+{
+    return (bytes + page_size-1) & ~(page_size-1);
+}
 inline void GENERATE_TEMP_FILE (const File& file, bool ulink)
 {
     // Create the file path template (the 'X' values will be modified).Co
@@ -305,6 +393,54 @@ inline size_t GET_FILE_SIZE (const File& file)
     file->size = size;
     return size;
 }
+inline void EXTEND_FILE_STORAGE (int posix_file, size_t size, size_t bytes)
+{
+    // Allocate the new blocks up front where supported so that writes into
+    // the grown range neither fault on a sparse hole nor fail for space.
+    #if __linux__
+    if (fallocate(posix_file, 0, size, bytes - size) == 0) return;
+    if (errno != EOPNOTSUPP && errno != ENOSYS)
+        throw std::system_error(errno,std::generic_category(),
+                                "Failed to fallocate-resize file");
+    #endif
+    if (ftruncate(posix_file, bytes) == -1)
+        throw std::system_error(errno,std::generic_category(),
+                                "Failed to ftruncate-resize file");
+}
+inline size_t RESIZE_RESERVED_FILE (const File& file, size_t bytes)
+{
+    auto& ptr       = file->ptr;
+    auto& size      = file->size;
+    if (bytes > file->reserved) throw std::system_error
+        (ENOMEM, std::generic_category(),
+         "File size would exceed its reserved address range");
+    
+    int posix_file  = fileno(file->handle);
+    if (bytes > size) EXTEND_FILE_STORAGE(posix_file, size, bytes);
+    else if (ftruncate(posix_file, bytes) == -1)
+        throw std::system_error(errno,std::generic_category(),
+                                "Failed to ftruncate-resize file");
+    
+    // Map only the pages that changed. MAP_FIXED replaces the reserved
+    // (or released) pages in place, so the base pointer never moves and
+    // existing pages are never unmapped beneath concurrent writers.
+    const size_t mapped     = PAGE_CEIL(size);
+    const size_t required   = PAGE_CEIL(bytes);
+    void* result            = ptr + mapped;
+    if (required > mapped)
+        result = mmap(ptr + mapped, required - mapped,
+                      file->writeAccess ? PROT_READ | PROT_WRITE : PROT_READ,
+                      MAP_SHARED | MAP_FIXED, posix_file, mapped);
+    else if (required < mapped)
+        result = mmap(ptr + required, mapped - required, PROT_NONE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0);
+    if (result == MAP_FAILED)
+        throw std::system_error(errno,std::generic_category(),
+                                "Failed to map resized file within its reserved range");
+    
+    size = bytes;
+    return bytes;
+}
 inline size_t RESIZE_FILE (const File& file, size_t bytes)
 {
     auto& handle    = file->handle;
@@ -315,6 +451,9 @@ inline size_t RESIZE_FILE (const File& file, size_t bytes)
     // Return if no change needed
     if (size == bytes) return size;
     
+    // Reserved mappings grow and shrink in place
+    if (file->reserved) return RESIZE_RESERVED_FILE(file, bytes);
+    
     // Set the new file size
     result = ftruncate(fileno(handle), bytes);
     if (result == -1)
@@ -368,17 +507,70 @@ inline void PERFORM_FILE_MAPPING (const File& file)
         throw std::system_error(errno,std::generic_category(),
                                 "failed to get a posix file descriptor to map.");
     
+    // Optionally fault every page in up front (ex. hot slides)
+    const auto& options = file->mapping;
+    int map_flags = MAP_SHARED;                             // Allow other processes to see updates
+    #ifdef MAP_POPULATE
+    if (options.populate) map_flags |= MAP_POPULATE;
+    #endif
+    
     // Map the file into memory using MMAP
     file->ptr = static_cast<BYTE*>(mmap(NULL, file->size,  // No initial ptr, but map all bytes
                                         access_flags,      // Access map based on write vs read/write
-                                        MAP_SHARED,        // Allow other processes to see updates
+                                        map_flags,
                                         posix_file,0));    // Get the file descriptor, no offset
     
     // If no pointer was returned, the
     if (file->ptr == MAP_FAILED)
         throw std::system_error(errno,std::generic_category(),
                                 "failed to map the file.");
-
+    
+    // The remaining options are advice. Failures (ex. a file system without
+    // huge page support) leave the mapping as it would otherwise have been.
+    switch (options.access) {
+        case FILE_ACCESS_NORMAL: break;
+        case FILE_ACCESS_RANDOM:
+            madvise(file->ptr, file->size, MADV_RANDOM); break;
+        case FILE_ACCESS_SEQUENTIAL:
+            madvise(file->ptr, file->size, MADV_SEQUENTIAL); break;
+    }
+    #ifdef MADV_HUGEPAGE
+    if (options.hugePages) madvise(file->ptr, file->size, MADV_HUGEPAGE);
+    #endif
+    #ifndef MAP_POPULATE
+    if (options.populate) madvise(file->ptr, file->size, MADV_WILLNEED);
+    #endif
+}
+inline void RESERVE_ADDRESS_RANGE (const File& file, size_t bytes)
+{
+    bytes = PAGE_CEIL(bytes);
+    if (file->reserved) throw std::runtime_error
+        ("File already has a reserved address range");
+    if (bytes <= PAGE_CEIL(file->size)) return;
+    
+    // Reserve inaccessible address space; no memory or swap is committed.
+    // Of note, we will NEVER EVER PROT_EXEC for safety. EVER.
+    auto range = static_cast<BYTE*>(mmap(NULL, bytes, PROT_NONE,
+                                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                                         -1, 0));
+    if (range == MAP_FAILED)
+        throw std::system_error(errno,std::generic_category(),
+                                "Failed to reserve file address range");
+    
+    // Map the current file contents over the start of the range
+    int posix_file = fileno(file->handle);
+    if (file->size && mmap(range, file->size,
+                           file->writeAccess ? PROT_READ | PROT_WRITE : PROT_READ,
+                           MAP_SHARED | MAP_FIXED, posix_file, 0) == MAP_FAILED) {
+        int error = errno;
+        munmap(range, bytes);
+        throw std::system_error(error,std::generic_category(),
+                                "Failed to map file into its reserved address range");
+    }
+    
+    if (file->ptr) munmap(file->ptr, file->size);
+    file->ptr       = range;
+    file->reserved  = bytes;
 }
 inline bool LOCK_FILE (const File& file, bool exclusive, bool wait)
 {
@@ -414,6 +606,174 @@ inline void UNLOCK_FILE (const File& file)
         throw std::system_error(errno,std::generic_category(),
                                 "failed to unlock the file");
 }
+inline void ADVISE_FILE_RANGE (const File& file, Offset offset, Size bytes, FileAdvice advice)
+{
+    int posix_advice = MADV_NORMAL;
+    switch (advice) {
+        case FILE_ADVICE_WILL_NEED: posix_advice = MADV_WILLNEED; break;
+        case FILE_ADVICE_DONT_NEED: posix_advice = MADV_DONTNEED; break;
+    }
+    // The mapping is MAP_SHARED so MADV_DONTNEED only drops this process's
+    // page references; the page cache and file contents are unaffected.
+    if (madvise(file->ptr + offset, bytes, posix_advice) == -1)
+        throw std::system_error(errno,std::generic_category(),
+                                "failed to advise the file mapping");
+}
+inline void CREATE_FILE_IMAGE (const File& file)
+{
+    // Private anonymous memory standing in for the mapping of a block cached
+    // file. Pages are only committed once loaded into, so the tile data
+    // that is never loaded costs nothing.
+    auto image = mmap(NULL, file->size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (image == MAP_FAILED)
+        throw std::system_error(errno,std::generic_category(),
+                                "failed to allocate the file image.");
+    file->ptr = static_cast<BYTE*>(image);
+}
+inline size_t READ_FILE_RANGE (const File& file, Offset offset, BYTE* data, Size bytes)
+{
+    const int posix_file = fileno(file->handle);
+    size_t    total      = 0;
+    while (bytes) {
+        const auto count = pread(posix_file, data, bytes, static_cast<off_t>(offset));
+        if (count == -1) {
+            if (errno == EINTR) continue;
+            throw std::system_error(errno,std::generic_category(),
+                                    "failed to read from the file");
+        }
+        if (count == 0) break; // End of file
+        data   += count;
+        offset += count;
+        bytes  -= count;
+        total  += count;
+    }
+    return total;
+}
+inline size_t READ_FILE_BLOCKS (const File& file, Offset offset, Buffer* blocks, size_t count)
+{
+    // Scatter a run of consecutive blocks directly into their own buffers,
+    // each filled to its capacity and sized to the bytes it received.
+    const int posix_file = fileno(file->handle);
+    std::vector<iovec> vectors (count);
+    for (size_t index = 0; index < count; ++index) {
+        blocks[index]->set_size(0);
+        vectors[index] = iovec {blocks[index]->data(), blocks[index]->capacity()};
+    }
+    size_t total = 0;
+    for (size_t index = 0; index < count;) {
+        const int  batch = static_cast<int>(std::min<size_t>(count - index, IOV_MAX));
+        const auto read  = preadv(posix_file, vectors.data() + index, batch,
+                                  static_cast<off_t>(offset + total));
+        if (read == -1) {
+            if (errno == EINTR) continue;
+            throw std::system_error(errno,std::generic_category(),
+                                    "failed to read from the file");
+        }
+        if (read == 0) break; // End of file
+        total += read;
+        
+        // Retire the filled vectors and trim a partially filled one
+        auto remaining = static_cast<size_t>(read);
+        while (remaining && remaining >= vectors[index].iov_len) {
+            remaining -= vectors[index].iov_len;
+            blocks[index]->set_size(blocks[index]->capacity());
+            ++index;
+        }
+        if (remaining) {
+            vectors[index].iov_base = static_cast<BYTE*>(vectors[index].iov_base) + remaining;
+            vectors[index].iov_len -= remaining;
+            blocks[index]->set_size(blocks[index]->capacity() - vectors[index].iov_len);
+        }
+    }
+    return total;
+}
+inline void SET_WRITE_BACKEND (const File& file, FileWriteBackend backend)
+{
+    if (backend == FILE_WRITE_DIRECT && file->direct == -1) {
+        // Open a second descriptor that bypasses the page cache; the
+        // stream handle keeps serving the mapping and buffered writes.
+        if (file->linked == false) throw std::runtime_error
+            ("Direct writes require a file that is linked within the file system");
+        #if __APPLE__
+        int posix_file = open(file->path.c_str(), O_WRONLY);
+        if (posix_file != -1 && fcntl(posix_file, F_NOCACHE, 1) == -1) {
+            const int error = errno;
+            close(posix_file);
+            posix_file = -1;
+            errno = error;
+        }
+        #else
+        int posix_file = open(file->path.c_str(), O_WRONLY | O_DIRECT);
+        #endif
+        if (posix_file == -1)
+            throw std::system_error(errno,std::generic_category(),
+                                    "failed to open the file for direct writes");
+        file->direct = posix_file;
+    }
+    file->backend = backend;
+}
+inline void WRITE_FILE_RANGE (const File& file, Offset offset, const BYTE* data, Size bytes)
+{
+    if (file->backend == FILE_WRITE_MAPPED) {
+        auto shared_write_lock = file->read_lock();
+        memcpy(file->ptr + offset, data, bytes);
+        return;
+    }
+    const int posix_file = file->backend == FILE_WRITE_DIRECT ?
+                           file->direct : fileno(file->handle);
+    while (bytes) {
+        const auto written = pwrite(posix_file, data, bytes, static_cast<off_t>(offset));
+        if (written == -1) {
+            if (errno == EINTR) continue;
+            throw std::system_error(errno,std::generic_category(),
+                                    "failed to write to the file");
+        }
+        data   += written;
+        offset += written;
+        bytes  -= written;
+    }
+}
+inline void MOVE_FILE_RANGE (const File& file, Offset source, Offset destination, Size bytes)
+{
+    if (file->backend == FILE_WRITE_MAPPED) {
+        auto shared_write_lock = file->read_lock();
+        memmove(file->ptr + destination, file->ptr + source, bytes);
+        return;
+    }
+    // Copy through an aligned bounce buffer with positional reads and writes
+    // so the moved bytes never pass through (and dirty) the shared mapping.
+    // Copying forward is safe for overlapping ranges moved toward the start.
+    struct Free {
+        void operator () (BYTE* __p) const
+        {::operator delete (__p, std::align_val_t(FILE_DIRECT_ALIGNMENT));}
+    };
+    constexpr Size chunk = 1ULL << 20;
+    std::unique_ptr<BYTE, Free> buffer (static_cast<BYTE*>(::operator new
+        (chunk, std::align_val_t(FILE_DIRECT_ALIGNMENT))));
+    for (Size copied = 0; copied < bytes;) {
+        const Size count = std::min(chunk, bytes - copied);
+        if (READ_FILE_RANGE(file, source + copied, buffer.get(), count) != count)
+            throw std::runtime_error("unexpected end of file while moving file bytes");
+        WRITE_FILE_RANGE(file, destination + copied, buffer.get(), count);
+        copied += count;
+    }
+}
+inline void SYNC_FILE (const File& file)
+{
+    // Write back the dirty pages of the mapping and then flush the file;
+    // fsync also covers positional writes made through either descriptor
+    // and the file size, which the mapped bytes depend upon.
+    {
+        auto shared_write_lock = file->read_lock();
+        if (msync(file->ptr, file->size, MS_SYNC) == -1)
+            throw std::system_error(errno,std::generic_category(),
+                                    "failed to write back the file mapping");
+    }
+    if (fsync(fileno(file->handle)) == -1)
+        throw std::system_error(errno,std::generic_category(),
+                                "failed to flush the file");
+}
 inline void UNMAP_FILE (BYTE*& ptr, size_t bytes)
 {
     // If there is a ptr, unmap it
@@ -423,6 +783,93 @@ inline void UNMAP_FILE (BYTE*& ptr, size_t bytes)
     ptr = NULL;
 }
 #endif // END POSIX COMPLIENT
+// MARK: - Block Cached File Reads
+inline void INSERT_CACHED_BLOCK (__INTERNAL__BlockCache& cache, uint64_t block, const Buffer& bytes)
+{
+    // The cache mutex must be held. A block read concurrently by another
+    // thread is already present; keep the first copy.
+    if (cache.blocks.count(block)) return;
+    cache.recent.push_front(block);
+    cache.blocks.emplace(block, __INTERNAL__BlockCache::Entry {bytes, cache.recent.begin()});
+    cache.bytes += bytes->size();
+    while (cache.bytes > cache.budget && cache.recent.size() > 1) {
+        auto victim = cache.blocks.find(cache.recent.back());
+        cache.bytes -= victim->second.first->size();
+        cache.blocks.erase(victim);
+        cache.recent.pop_back();
+    }
+}
+inline void CACHE_FILE_BLOCKS (const File& file, uint64_t first, uint64_t last, std::vector<Buffer>& blocks)
+{
+    constexpr Size block_size = __INTERNAL__BlockCache::block_size;
+    auto& cache = *file->cache;
+    blocks.assign(last - first + 1, NULL);
+    {
+        MutexLock __ (cache.mutex);
+        for (auto block = first; block <= last; ++block) {
+            auto entry = cache.blocks.find(block);
+            if (entry == cache.blocks.end()) continue;
+            cache.recent.splice(cache.recent.begin(), cache.recent, entry->second.second);
+            blocks[block - first] = entry->second.first;
+        }
+    }
+    
+    // Read the missing blocks in runs of consecutive blocks so that adjacent
+    // tile ranges cost a single read rather than one per tile
+    for (auto run = first; run <= last;) {
+        if (blocks[run - first]) {++run; continue;}
+        auto end = run;
+        while (end <= last && !blocks[end - first]) ++end;
+        
+        // Each block is read straight into the buffer the cache keeps
+        for (auto block = run; block < end; ++block) {
+            const Offset start = block * block_size;
+            blocks[block - first] = Create_strong_buffer
+            (start < file->size ? std::min<Size>(block_size, file->size - start) : 0);
+        }
+        READ_FILE_BLOCKS(file, run * block_size, &blocks[run - first], end - run);
+        
+        MutexLock __ (cache.mutex);
+        for (auto block = run; block < end; ++block)
+            INSERT_CACHED_BLOCK(cache, block, blocks[block - first]);
+        run = end;
+    }
+}
+inline void ADVISE_CACHED_FILE (const File& file, const FileAdviseInfo& info)
+{
+    // Block align the ranges and coalesce adjacent or overlapping ones
+    constexpr Size block_size = __INTERNAL__BlockCache::block_size;
+    std::vector<std::pair<uint64_t, uint64_t>> runs; // first, last block
+    runs.reserve(info.ranges.size());
+    for (auto& range : info.ranges) if (range.second && range.first < file->size) {
+        const Offset end = std::min<Offset>(range.first + range.second, file->size);
+        runs.emplace_back(range.first / block_size, (end - 1) / block_size);
+    }
+    std::sort(runs.begin(), runs.end());
+    
+    auto& cache = *file->cache;
+    std::vector<Buffer> blocks;
+    for (size_t index = 0; index < runs.size();) {
+        auto first = runs[index].first, last = runs[index].second;
+        for (++index; index < runs.size() && runs[index].first <= last + 1; ++index)
+            last = std::max(last, runs[index].second);
+        switch (info.advice) {
+            case FILE_ADVICE_WILL_NEED:
+                CACHE_FILE_BLOCKS(file, first, last, blocks);
+                break;
+            case FILE_ADVICE_DONT_NEED: {
+                MutexLock __ (cache.mutex);
+                for (auto block = first; block <= last; ++block) {
+                    auto entry = cache.blocks.find(block);
+                    if (entry == cache.blocks.end()) continue;
+                    cache.bytes -= entry->second.first->size();
+                    cache.recent.erase(entry->second.second);
+                    cache.blocks.erase(entry);
+                }
+            } break;
+        }
+    }
+}
 // MARK: - Iris Codec File API Calls
 File create_file (const struct FileCreateInfo &create_info)
 {
@@ -484,8 +931,14 @@ File    open_file (const struct FileOpenInfo &open_info)
         // Get the file size.
         GET_FILE_SIZE(file);
         
-        // Map the file into memory
-        PERFORM_FILE_MAPPING(file);
+        // Map the file into memory, or for block cached reads create the
+        // in-memory image that stands in for the mapping
+        if (open_info.readBackend == FILE_READ_BLOCK_CACHE) {
+            if (open_info.writeAccess) throw std::runtime_error
+                ("Block cached files must be opened read-only");
+            file->cache = std::make_unique<__INTERNAL__BlockCache>(open_info.blockCacheBytes);
+            CREATE_FILE_IMAGE(file);
+        } else PERFORM_FILE_MAPPING(file);
         
         // Return the newly mapped file
         return file;
@@ -558,6 +1011,186 @@ Result resize_file (const File &file, const struct FileResizeInfo &info)
         };
     } return IRIS_FAILURE;
 }
+Result reserve_file (const File &file, const struct FileReserveInfo &info)
+{
+    if (file->writeAccess == false) return Iris::Result
+        (IRIS_FAILURE, "Only writable files may reserve an address range to grow into");
+    try {
+        WriteLock __ (file->resize);
+        RESERVE_ADDRESS_RANGE (file, info.size);
+        return IRIS_SUCCESS;
+    } catch (std::system_error &e) {
+        return Iris::Result
+        (IRIS_FAILURE, std::string("Failed to reserve file address range: ")+e.what());
+    } catch (std::runtime_error &e) {
+        return Iris::Result
+        (IRIS_FAILURE, std::string("Failed to reserve file address range: ")+e.what());
+    }   return IRIS_FAILURE;
+}
+Result read_file_range (const File &file, const FileRange &range, Buffer &bytes)
+{
+    if (range.first + range.second > file->size) return Iris::Result
+        (IRIS_FAILURE, "File range extends beyond the end of the file");
+    if (!file->cache) {
+        bytes = Wrap_weak_buffer_fom_data(file->ptr + range.first, range.second);
+        return IRIS_SUCCESS;
+    }
+    try {
+        bytes = Create_strong_buffer(range.second);
+        bytes->set_size(range.second);
+        if (range.second == 0) return IRIS_SUCCESS;
+        
+        constexpr Size block_size = __INTERNAL__BlockCache::block_size;
+        std::vector<Buffer> blocks;
+        CACHE_FILE_BLOCKS(file, range.first / block_size,
+                          (range.first + range.second - 1) / block_size, blocks);
+        auto   data      = static_cast<BYTE*>(bytes->data());
+        Offset offset    = range.first;
+        Size   remaining = range.second;
+        for (auto& block : blocks) {
+            const Size start = offset % block_size;
+            const Size copy  = std::min<Size>(remaining, block_size - start);
+            if (start + copy > block->size()) throw std::runtime_error
+                ("the file was truncated while being read");
+            memcpy(data, static_cast<const BYTE*>(block->data()) + start, copy);
+            data      += copy;
+            offset    += copy;
+            remaining -= copy;
+        }
+        return IRIS_SUCCESS;
+    } catch (std::system_error &e) {
+        return Iris::Result
+        (IRIS_FAILURE, std::string("Failed to read file range: ")+e.what());
+    } catch (std::runtime_error &e) {
+        return Iris::Result
+        (IRIS_FAILURE, std::string("Failed to read file range: ")+e.what());
+    }   return IRIS_FAILURE;
+}
+Result load_file_range (const File &file, const FileRange &range)
+{
+    // Mapped files are always addressable in full
+    if (!file->cache) return IRIS_SUCCESS;
+    if (range.first + range.second > file->size) return Iris::Result
+        (IRIS_FAILURE, "File range extends beyond the end of the file");
+    try {
+        if (READ_FILE_RANGE(file, range.first, file->ptr + range.first, range.second) != range.second)
+            throw std::runtime_error("unexpected end of file");
+        return IRIS_SUCCESS;
+    } catch (std::system_error &e) {
+        return Iris::Result
+        (IRIS_FAILURE, std::string("Failed to load file range: ")+e.what());
+    } catch (std::runtime_error &e) {
+        return Iris::Result
+        (IRIS_FAILURE, std::string("Failed to load file range: ")+e.what());
+    }   return IRIS_FAILURE;
+}
+Result set_file_write_backend (const File &file, FileWriteBackend backend)
+{
+    if (file->writeAccess == false) return Iris::Result
+        (IRIS_FAILURE, "Only writable files may select a write backend");
+    try {
+        SET_WRITE_BACKEND (file, backend);
+        return IRIS_SUCCESS;
+    } catch (std::system_error &e) {
+        return Iris::Result
+        (IRIS_FAILURE, std::string("Failed to select the file write backend: ")+e.what());
+    } catch (std::runtime_error &e) {
+        return Iris::Result
+        (IRIS_FAILURE, std::string("Failed to select the file write backend: ")+e.what());
+    }   return IRIS_FAILURE;
+}
+Result write_file (const File &file, const FileWriteInfo &info)
+{
+    if (info.size == 0) return IRIS_SUCCESS;
+    if (file->backend == FILE_WRITE_DIRECT &&
+        ((info.offset | info.size | reinterpret_cast<uintptr_t>(info.data)) & (FILE_DIRECT_ALIGNMENT-1)))
+        return Iris::Result
+        (IRIS_FAILURE, "Direct file writes must be aligned in offset, size, and memory");
+    try {
+        WRITE_FILE_RANGE (file, info.offset, info.data, info.size);
+        return IRIS_SUCCESS;
+    } catch (std::system_error &e) {
+        return Iris::Result
+        (IRIS_FAILURE, std::string("Failed to write to file: ")+e.what());
+    }   return IRIS_FAILURE;
+}
+Result move_file_range (const File &file, const FileMoveInfo &info)
+{
+    if (file->writeAccess == false) return Iris::Result
+        (IRIS_FAILURE, "Only writable files may move bytes within them");
+    if (info.size == 0) return IRIS_SUCCESS;
+    if (info.destination > info.source) return Iris::Result
+        (IRIS_FAILURE, "File bytes may only be moved toward the start of the file");
+    if (file->backend == FILE_WRITE_DIRECT &&
+        ((info.source | info.destination | info.size) & (FILE_DIRECT_ALIGNMENT-1)))
+        return Iris::Result
+        (IRIS_FAILURE, "Direct file moves must be aligned in offsets and size");
+    try {
+        MOVE_FILE_RANGE (file, info.source, info.destination, info.size);
+        return IRIS_SUCCESS;
+    } catch (std::system_error &e) {
+        return Iris::Result
+        (IRIS_FAILURE, std::string("Failed to move file bytes: ")+e.what());
+    } catch (std::runtime_error &e) {
+        return Iris::Result
+        (IRIS_FAILURE, std::string("Failed to move file bytes: ")+e.what());
+    }   return IRIS_FAILURE;
+}
+Result sync_file (const File &file)
+{
+    if (file->writeAccess == false) return IRIS_SUCCESS;
+    try {
+        SYNC_FILE (file);
+        return IRIS_SUCCESS;
+    } catch (std::system_error &e) {
+        return Iris::Result
+        (IRIS_FAILURE, std::string("Failed to flush file to storage: ")+e.what());
+    }   return IRIS_FAILURE;
+}
+Result advise_file (const File &file, const struct FileAdviseInfo &info)
+{
+    if (info.ranges.empty()) return IRIS_SUCCESS;
+    
+    // Block cached files are not mapped; read ahead into (or release from)
+    // the block cache instead.
+    if (file->cache) try {
+        ADVISE_CACHED_FILE (file, info);
+        return IRIS_SUCCESS;
+    } catch (std::system_error &e) {
+        return Iris::Result
+        (IRIS_FAILURE, std::string("Failed to advise file block cache: ")+e.what());
+    }
+    
+    // Page align every range and sort them so that adjacent or overlapping
+    // ranges (ex. consecutive tiles) are coalesced into a single system call.
+    std::vector<FileRange> ranges;
+    ranges.reserve(info.ranges.size());
+    for (auto& range : info.ranges) if (range.second) {
+        const Offset start  = range.first & ~(page_size-1);
+        const Offset end    = (range.first + range.second + page_size-1) & ~(page_size-1);
+        ranges.emplace_back(start, end - start);
+    }
+    std::sort(ranges.begin(), ranges.end());
+    
+    try {
+        auto lock = file->read_lock();
+        const Offset file_end = file->size;
+        Offset start = 0, end = 0;
+        for (auto& range : ranges) {
+            if (range.first > end) {
+                if (end > start) ADVISE_FILE_RANGE(file, start, end - start, info.advice);
+                start = range.first;
+            }
+            end = std::min<Offset>(std::max<Offset>(end, range.first + range.second),
+                                   (file_end + page_size-1) & ~(page_size-1));
+        }
+        if (end > start) ADVISE_FILE_RANGE(file, start, end - start, info.advice);
+        return IRIS_SUCCESS;
+    } catch (std::system_error &e) {
+        return Iris::Result
+        (IRIS_FAILURE, std::string("Failed to advise file mapping: ")+e.what());
+    }   return IRIS_FAILURE;
+}
 Result rename_file(const File &file, const std::string &new_path)
 {
     if (file->get_path() == new_path) return IRIS_SUCCESS;
@@ -593,6 +1226,7 @@ Result delete_file(const File &file)
 __INTERNAL__File::__INTERNAL__File  (const FileOpenInfo& info) :
     path                            (info.filePath),
     writeAccess                     (info.writeAccess),
+    mapping                         (info.mapping),
     linked                          (true)
 {
     
@@ -616,7 +1250,8 @@ __INTERNAL__File::~__INTERNAL__File ()
     #if _WIN32
     UNMAP_FILE  (map, ptr);
     #else
-    UNMAP_FILE  (ptr, size);
+    UNMAP_FILE  (ptr, reserved ? reserved : size);
+    if (direct != -1) close(direct);
     #endif
     
     // Close the file
@@ -634,4 +1269,27 @@ void __INTERNAL__File::rename_file (const std::string& new_path)
 {
     path = new_path;
 }
+ReadLock __INTERNAL__File::read_lock()
+{
+    // Readers of a read-only mapping would otherwise all contend on the
+    // reader count cache line of the shared mutex for no benefit. A reserved
+    // mapping is likewise never moved by a resize.
+    if (writeAccess == false || reserved)
+        return ReadLock (resize, std::defer_lock);
+    return ReadLock (resize);
+}
+__INTERNAL__FileLock::__INTERNAL__FileLock (const File& file) :
+_file                               (file),
+_lock                               (file->read_lock())
+{
+    
+}
+BYTE* __INTERNAL__FileLock::get_ptr() const
+{
+    return _file->ptr;
+}
+size_t __INTERNAL__FileLock::get_size() const
+{
+    return _file->size;
+}
 } // END IRIS CODEC NAMESPACE
@@ -9,6 +9,19 @@
 #define IrisCodecFile_hpp
 namespace IrisCodec {
 using namespace Iris;
+/// Bounded least-recently-used cache of fixed size file blocks read with
+/// pread. Serves block cached files in place of a file mapping.
+struct __INTERNAL__BlockCache {
+    static constexpr size_t         block_size  = 64ULL << 10;
+    using Recent                    = std::list<uint64_t>;  // Most recent first
+    using Entry                     = std::pair<Buffer, Recent::iterator>;
+    const size_t                    budget;
+    Mutex                           mutex;
+    Recent                          recent;
+    std::unordered_map<uint64_t, Entry> blocks;
+    size_t                          bytes       = 0;
+    explicit __INTERNAL__BlockCache (size_t __budget) : budget (__budget) {}
+};
 class __INTERNAL__File {
 public:
     std::string                     path;
@@ -19,8 +32,13 @@ public:
     HANDLE                          map = INVALID_HANDLE_VALUE;
 #endif
     BYTE*                           ptr;
+    size_t                          reserved = 0; // Address space reserved at ptr
     SharedMutex                     resize; //TODO: REPLACE THIS WITH FILE LOCK
     bool                            writeAccess;
+    FileMappingOptions              mapping;
+    std::unique_ptr<__INTERNAL__BlockCache> cache; // Block cached files only
+    FileWriteBackend                backend = FILE_WRITE_MAPPED;
+    int                             direct  = -1; // Descriptor for direct writes
     
     explicit __INTERNAL__File       (const FileOpenInfo&);
     explicit __INTERNAL__File       (const FileCreateInfo&);
@@ -31,6 +49,23 @@ public:
     std::string get_path            () const;
     BYTE*       get_ptr             () const;
     void        rename_file         (const std::string& new_path);
+    // Shared lock against remapping. Read-only mappings are never resized
+    // and reserved mappings grow in place, so for them the returned lock is
+    // deferred and no lock state is touched.
+    ReadLock    read_lock           ();
+};
+/// Lease on a file mapping. While a lease is held the mapping is kept alive
+/// and cannot be moved or resized, so weak views into it remain valid.
+/// Leases should be short lived on writable files: they block resizing.
+class __INTERNAL__FileLock {
+    const File                      _file;
+    ReadLock                        _lock;
+public:
+    explicit __INTERNAL__FileLock   (const File&);
+    __INTERNAL__FileLock            (const __INTERNAL__FileLock&) = delete;
+    __INTERNAL__FileLock operator = (const __INTERNAL__FileLock&) = delete;
+    BYTE*       get_ptr             () const;
+    size_t      get_size            () const;
 };
 }
 #endif /* IrisCodecFile_hpp */
@@ -39,6 +39,10 @@
 #endif
 #include <iostream>
 #include <assert.h>
+#include <span>
+#include <array>
+#include <list>
+#include <unordered_map>
 #include "IrisCore.hpp"
 #include "IrisCodecCore.hpp"
 #include "IrisBuffer.hpp"
@@ -48,6 +52,7 @@
 #include "IrisCodecPrivTypes.hpp"
 #include "IrisCodecFile.hpp"
 #include "IrisCodecContext.hpp"
+#include "IrisCodecTileCache.hpp"
 #include "IrisCodecSlide.hpp"
 #include "IrisCodecCache.hpp"
 #include "IrisCodecEncoder.hpp"
@@ -27,6 +27,12 @@ File    create_cache_file   (const struct CacheCreateInfo&);
 /// Resize a file
 Result  resize_file         (const File&, const struct FileResizeInfo&);
 
+/// Reserve address space for a writable file to grow into without remapping
+Result  reserve_file        (const File&, const struct FileReserveInfo&);
+
+/// Advise the operating system of the expected use of byte ranges within a mapped file
+Result  advise_file         (const File&, const struct FileAdviseInfo&);
+
 /// Rename a file
 Result  rename_file         (const File&, const std::string&);
 
@@ -37,17 +43,108 @@ struct FileCreateInfo {
     std::string     filePath;
     size_t          initial_size = static_cast<size_t>(5E6);
 };
+enum FileAccessAdvice {
+    FILE_ACCESS_NORMAL,         // Default kernel read-ahead
+    FILE_ACCESS_RANDOM,         // No read-ahead on faults (ex. serving scattered tiles)
+    FILE_ACCESS_SEQUENTIAL,     // Aggressive read-ahead (ex. whole slide passes)
+};
+/// Strategy for mapping an opened file. Each is a hint: options the
+/// platform or file system does not support are silently skipped.
+struct FileMappingOptions {
+    bool                populate    = false;    // Fault the whole file in when mapped
+    FileAccessAdvice    access      = FILE_ACCESS_NORMAL;
+    bool                hugePages   = false;    // Transparent huge pages where supported
+};
+enum FileReadBackend {
+    FILE_READ_MAPPED,           // Read through a shared mapping of the file
+    FILE_READ_BLOCK_CACHE,      // pread into a bounded block cache (ex. network file systems)
+};
 struct FileOpenInfo {
-    std::string     filePath;
-    bool            writeAccess = false;
+    std::string         filePath;
+    bool                writeAccess = false;
+    FileMappingOptions  mapping;
+    /// Block cached files are not mapped. Their pointer addresses a private
+    /// zeroed image of the file that holds only ranges explicitly loaded
+    /// with load_file_range; all other bytes are read with read_file_range.
+    FileReadBackend     readBackend = FILE_READ_MAPPED;
+    size_t              blockCacheBytes = 256ULL << 20;
 };
 struct FileResizeInfo {
     size_t          size;
     bool            pageAlign           = false;
 };
+struct FileReserveInfo {
+    size_t          size;               // Bytes of address space; never committed
+};
+enum FileAdvice {
+    FILE_ADVICE_WILL_NEED,      // Begin reading the ranges in ahead of access
+    FILE_ADVICE_DONT_NEED,      // Release the resident pages of the ranges
+};
+using FileRange = std::pair<Offset, Size>;
+struct FileAdviseInfo {
+    std::vector<FileRange>      ranges;
+    FileAdvice                  advice              = FILE_ADVICE_WILL_NEED;
+};
+enum FileWriteBackend {
+    FILE_WRITE_MAPPED,          // Copy into the shared mapping; the kernel writes back dirty pages
+    FILE_WRITE_POSITIONAL,      // Positional writes (pwrite) through the page cache
+    FILE_WRITE_DIRECT,          // Positional writes that bypass the page cache
+};
+/// Direct writes must be aligned to this many bytes in offset, size, and memory
+constexpr size_t FILE_DIRECT_ALIGNMENT = 4096;
+struct FileWriteInfo {
+    Offset          offset;
+    const BYTE*     data;
+    Size            size;
+};
+
+/// Read a byte range of a file. Mapped files return a weak view into the
+/// mapping, valid while the caller holds the file read lock. Block cached
+/// files return a strong copy assembled from cached (or newly read) blocks.
+Result  read_file_range     (const File&, const FileRange&, Buffer&);
+
+/// Read a byte range of a block cached file into its in-memory image, after
+/// which it may be addressed through the file pointer like a mapping.
+Result  load_file_range     (const File&, const FileRange&);
+
+/// Select how write_file stores bytes into a writable file. The mapping
+/// remains valid for reading and writing under every backend.
+Result  set_file_write_backend (const File&, FileWriteBackend);
+
+/// Write bytes into a file at an offset through its selected write backend
+Result  write_file          (const File&, const FileWriteInfo&);
+
+struct FileMoveInfo {
+    Offset          source;
+    Offset          destination;    // At or before the source
+    Size            size;
+};
+/// Move bytes toward the start of a writable file through its selected
+/// write backend; positional backends never touch the mapping to do so.
+Result  move_file_range     (const File&, const FileMoveInfo&);
+
+/// Flush the written bytes (mapped or positional) and size of a writable
+/// file to storage so that they survive the process or system failing.
+Result  sync_file           (const File&);
+
+/// Reduction applied while decoding a tile. JPEG tiles are scaled within
+/// the inverse DCT; other encodings are decoded and then box filtered.
+enum DecodeScale : uint8_t {
+    DECODE_SCALE_FULL           = 1,    // 256 px tiles
+    DECODE_SCALE_HALF           = 2,    // 128 px tiles
+    DECODE_SCALE_QUARTER        = 4,    // 64 px tiles
+    DECODE_SCALE_EIGHTH         = 8,    // 32 px tiles
+};
+/// AV1 codec tuning applied by a context to every AVIF tile and image it
+/// compresses or decompresses.
+struct AvifCodecOptions {
+    int             speed               = 10;       // 0 (slowest, smallest) to 10 (fastest)
+    int             threads             = 1;        // Threads given to each libavif codec
+    bool            autoTiling          = false;    // Split large images into AV1 tiles
+};
 struct CompressTileInfo {
     Buffer          pixelArray          = NULL;
-//    Buffer          destinationOptional = NULL;
+    Buffer          optionalDestination = NULL; // Reused if large enough
     Format          format              = Iris::FORMAT_UNDEFINED;
     Encoding        encoding            = TILE_ENCODING_UNDEFINED;
     Quality         quality             = QUALITY_DEFAULT;
@@ -58,6 +155,12 @@ struct DecompressTileInfo {
     Buffer          optionalDestination = NULL;
     Format          desiredFormat       = Iris::FORMAT_UNDEFINED;
     Encoding        encoding            = TILE_ENCODING_UNDEFINED;
+    /// Byte offset and row pitch at which to write the tile within the
+    /// optional destination. Used to decode directly into a larger image;
+    /// when either is set the destination must be provided and large enough.
+    size_t          destinationOffset   = 0;
+    size_t          rowPitch            = 0;
+    DecodeScale     scale               = DECODE_SCALE_FULL;
 };
 struct CompressImageInfo {
     Buffer          pixelArray          = NULL;
@@ -78,10 +181,203 @@ struct DecompressImageInfo {
     Format          desiredFormat       = Iris::FORMAT_UNDEFINED;
     ImageEncoding   encoding            = IMAGE_ENCODING_UNDEFINED;
 };
+struct PixelConvertInfo {
+    const BYTE*     source              = NULL;
+    BYTE*           destination         = NULL;
+    size_t          pixels              = 0;
+    Format          initial             = Iris::FORMAT_UNDEFINED;
+    Format          desired             = Iris::FORMAT_UNDEFINED;
+};
+/// Vectorized conversion between 8-bit pixel formats (red / blue channel
+/// swaps, alpha removal and opaque alpha fill). The source and destination
+/// must either be the same pointer (in place) or not overlap at all.
+void convert_pixel_format (const PixelConvertInfo&);
+
+/// Vectorized check that every pixel of an 8-bit pixel array is identical
+/// (ex. blank glass background tiles).
+bool is_uniform_pixels (const BYTE* pixels, size_t pixel_count, Format);
+
+// MARK: - SLIDE OPEN OPTIONS
+struct SlideOpenOptions {
+    FileMappingOptions          mapping;
+    /// Read tiles with pread through a bounded block cache rather than a
+    /// mapping; avoids fault latency and SIGBUS on network file systems.
+    FileReadBackend             readBackend         = FILE_READ_MAPPED;
+    size_t                      blockCacheBytes     = 256ULL << 20;
+    /// Share the file mapping and tile table with slides already opened on
+    /// the same file in this process (each slide keeps its own context and
+    /// tile cache). Only files opened with the same read backend and mapping
+    /// options (mapped) or block cache budget (block cached) are shared; a
+    /// slide asking for different ones opens the file anew.
+    bool                        share               = true;
+};
+
+/// Open a slide with control over how its file is mapped (ex. populate and
+/// back hot slides with huge pages to cut page faults and TLB misses).
+Slide open_slide (const SlideOpenInfo&, const SlideOpenOptions&) noexcept;
+
+// MARK: - SLIDE DEEP VALIDATION
+struct SlideValidationOptions {
+    /// Fraction of the tiles of each layer to decode, spread evenly over
+    /// the layer and stable between runs (1 decodes every tile)
+    float                       sampleFraction      = 1.f;
+};
+struct SlideTileFailure {
+    uint32_t                    layer               = 0;
+    uint32_t                    tile                = 0;
+    uint32_t                    x                   = 0;    // Tile column
+    uint32_t                    y                   = 0;    // Tile row
+    std::string                 message;
+};
+struct SlideValidationReport {
+    uint64_t                    tilesChecked        = 0;
+    uint64_t                    tilesFailed         = 0;
+    uint64_t                    bytesRead           = 0;    // Compressed tile bytes
+    double                      seconds             = 0.0;
+    double                      tilesPerSecond      = 0.0;
+    double                      megabytesPerSecond  = 0.0;
+    std::vector<SlideTileFailure> failures;                 // Ordered by layer and tile
+};
+
+/// Validate the slide file structure and then decode every tile of every
+/// layer (or a sample of them) in parallel on the context's worker threads.
+/// Fails if the structure or any tile fails; the report locates every
+/// failed tile and summarizes the decode throughput.
+Result validate_slide (const SlideOpenInfo&, const SlideValidationOptions&, SlideValidationReport&) noexcept;
+
+// MARK: - SLIDE SCALED READS
+/// Read a slide tile decoded at a reduced scale (ex. a 64 px tile for
+/// DECODE_SCALE_QUARTER). Cheaper than a full decode and downsample.
+Buffer read_slide_tile (const SlideTileReadInfo&, DecodeScale) noexcept;
+
+// MARK: - SLIDE INFORMATION
+/// Get the slide extent. Unlike get_slide_info, this does not require the
+/// slide metadata and associated images to be parsed.
+Result get_slide_extent (const Slide&, Extent&) noexcept;
+
+// MARK: - SLIDE BATCH READ STRUCTURES
+struct SlideTilesReadInfo {
+    Slide                       slide               = NULL;
+    uint32_t                    layerIndex          = 0;
+    std::span<const uint32_t>   tileIndices;
+    /// Optional per-tile destinations. If provided, it must be the same
+    /// length as tileIndices; NULL or undersized entries are allocated.
+    std::span<const Buffer>     optionalDestinations;
+    Format                      desiredFormat       = Iris::FORMAT_R8G8B8A8;
+};
+struct SlideTileReadResult {
+    uint32_t                    tileIndex           = 0;
+    Result                      result              = IRIS_FAILURE;
+    Buffer                      pixels              = NULL;
+};
+using SlideTileReadResults = std::vector<SlideTileReadResult>;
+
+/// Read and decompress a batch of tiles from a single slide layer. Tiles
+/// are decoded in parallel on the slide context's worker threads. Results
+/// are returned in the order of tileIndices; a failed tile does not fail
+/// the remainder of the batch.
+SlideTileReadResults read_slide_tiles (const SlideTilesReadInfo&) noexcept;
+
+// MARK: - SLIDE REGION READ STRUCTURES
+struct SlideRegionReadInfo {
+    Slide                       slide               = NULL;
+    uint32_t                    layerIndex          = 0;
+    /// Region origin and size in pixels of the given layer
+    uint32_t                    xOffset             = 0;
+    uint32_t                    yOffset             = 0;
+    uint32_t                    width               = 0;
+    uint32_t                    height              = 0;
+    Buffer                      optionalDestination = NULL;
+    Format                      desiredFormat       = Iris::FORMAT_R8G8B8A8;
+};
+
+/// Read an arbitrary pixel region from a slide layer. Only the tiles
+/// the region touches are decoded; they are decoded in parallel and
+/// written directly into a single tightly packed output image.
+Buffer read_slide_region (const SlideRegionReadInfo&) noexcept;
+
+// MARK: - SLIDE PREFETCH STRUCTURES
+struct SlidePrefetchInfo {
+    Slide                       slide               = NULL;
+    uint32_t                    layerIndex          = 0;
+    std::span<const uint32_t>   tileIndices;
+};
+
+/// Begin asynchronously paging in the compressed bytes of the given slide
+/// tiles so that the I/O overlaps with decoding. Returns immediately.
+Result prefetch_slide_tiles (const SlidePrefetchInfo&) noexcept;
+
+/// Prefetch every tile touched by a pixel region (viewport) of a slide layer.
+/// The destination buffer and format of the region read info are ignored.
+Result prefetch_slide_region (const SlideRegionReadInfo&) noexcept;
+
+/// Release the resident pages holding a layer's compressed tiles. This is a
+/// hint to bound memory use once a layer is no longer being viewed; the
+/// layer remains readable and will simply be paged in again if accessed.
+Result evict_slide_layer (const Slide&, uint32_t layerIndex) noexcept;
+
+// MARK: - SLIDE TILE CACHE STRUCTURES
+struct TileCacheStats {
+    size_t                      budget              = 0;
+    size_t                      bytes               = 0;
+    uint64_t                    entries             = 0;
+    uint64_t                    hits                = 0;
+    uint64_t                    misses              = 0;
+    uint64_t                    evictions           = 0;
+};
+
+/// Set the byte budget of a slide's decoded tile cache. Slides inherit the
+/// budget of their context when opened; a budget of zero disables the cache.
+Result set_slide_tile_cache_budget (const Slide&, size_t bytes) noexcept;
+
+/// Get the decoded tile cache usage and hit / miss statistics of a slide.
+Result get_slide_tile_cache_stats (const Slide&, TileCacheStats&) noexcept;
+
 // MARK: - FILE ACCESS DATA STRUCTURES
 using FileLock = std::shared_ptr<class __INTERNAL__FileLock>;
+/// Zero-copy view of bytes within a mapped slide file. The bytes buffer is a
+/// weak wrapper around the mapping and is valid only while the lease is held.
+/// The offset is the location of the bytes within the file (ex. for sendfile).
+struct MappedView {
+    Buffer                      bytes               = NULL;
+    Offset                      offset              = 0;
+    FileLock                    lease               = NULL;
+};
+
+/// Get a zero-copy view of a compressed slide tile entry within the slide file.
+Result get_slide_tile_view (const Slide&, uint32_t layer, uint32_t tile, MappedView&) noexcept;
+
+/// Get a zero-copy view of an encoded associated image within the slide file.
+Result get_associated_image_view (const Slide&, const std::string& image_label, MappedView&) noexcept;
 
 // MARK: - ENCODER STRUCTURES
+struct EncoderDedupStats {
+    uint32_t                    tilesWritten        = 0;    // Tiles given a table entry
+    uint32_t                    tilesShared         = 0;    // Of which reuse stored bytes
+    uint64_t                    bytesSaved          = 0;
+    float                       ratio               = 0.f;  // tilesShared / tilesWritten
+};
+
+/// Get the number of encoded tiles whose table entries reference bytes
+/// already stored in the slide file (uniform or byte-identical tiles).
+Result get_encoder_dedup_stats (const Encoder&, EncoderDedupStats&) noexcept;
+
+/// Select how the encoder writes tiles into the output file. By default they
+/// are copied into the file mapping; positional writes instead keep dirty
+/// page writeback under the encoder's control (ex. network file systems).
+Result set_encoder_write_backend (const Encoder&, FileWriteBackend) noexcept;
+
+struct EncoderCheckpointOptions {
+    bool                        enabled             = false;
+    uint32_t                    interval            = 30;   // Seconds between checkpoints
+};
+
+/// Periodically journal the tiles durably written to the temporary output
+/// file. An encode that dies (ex. killed or preempted) leaves the journal
+/// and partial file behind; dispatching an encoder with the same source and
+/// destination then resumes it, encoding only the tiles not yet journaled.
+Result set_encoder_checkpoints (const Encoder&, const EncoderCheckpointOptions&) noexcept;
+
 enum __tileStatus {
     TILE_FREE,
     TILE_INITIALIZING,
@@ -98,11 +394,13 @@ static_assert(std::is_same<Subtile, uint16_t>::value,
 "If you change/expand subtile flag, remember to update the \
 SUBTILESCMPLT to the max value of the new type");
 using DcmFile = std::shared_ptr<struct __INTERNAL__DcmFile>;
+using SvsFile = std::shared_ptr<struct __INTERNAL__SvsFile>;
 struct TileTracker {
     std::atomic<__tileStatus>   status;
     SubtileTracker              subtile;
     Iris::Buffer                pixels  = NULL;
     Iris::Buffer                stream  = NULL;
+    bool                        restored = false; // Stored by an earlier encode
     TileTracker() :
     status  (TILE_FREE),
     subtile (0){}
@@ -121,7 +419,68 @@ struct EncoderSource {
     Slide           irisSlide   = NULL;
     DcmFile         dicomFile   = NULL;
     openslide_t*    openslide   = NULL;
-    TIFF*           svs         = NULL;
+    SvsFile         svsFile     = NULL;
+};
+using TileEntry                 = Abstraction::TileTable::Layer::value_type;
+/// Uniform (single color) tiles already written during an encode, keyed by
+/// their packed pixel value. Repeats of a color reference the stored tile.
+struct UniformTileRegistry {
+    Mutex                                       mutex;
+    std::unordered_map<uint32_t, TileEntry>     entries;
+};
+/// Compressed tile streams already written during an encode, keyed by a hash
+/// of their bytes. Sharded so that concurrent tile writers rarely contend.
+struct TileHashRegistry {
+    struct alignas(64) Shard {
+        Mutex                                   mutex;
+        std::unordered_map<uint64_t, TileEntry> entries;
+    };
+    static constexpr size_t                     shard_count = 16;
+    std::array<Shard, shard_count>              shards;
+};
+/// Tile bytes of a write extent that have yet to be written to the file
+/// when it is written with positional writes rather than through its mapping.
+/// Hashes of staged tiles are held back until the tile bytes are written so
+/// that deduplication never compares against bytes not yet in the file.
+struct WriteStage {
+    static constexpr size_t                     alignment   = FILE_DIRECT_ALIGNMENT;
+    static constexpr size_t                     capacity    = 1ULL << 20;
+    struct Free {
+        void operator () (BYTE* __p) const
+        {::operator delete (__p, std::align_val_t(alignment));}
+    };
+    using Pending = std::vector<std::pair<uint64_t, TileEntry>>;
+    std::unique_ptr<BYTE, Free>                 data;
+    Offset                                      offset      = 0;    // File offset of data
+    Size                                        size        = 0;    // Bytes staged
+    Pending                                     hashes;             // Registered once written
+};
+/// A contiguous run of the output file reserved by one tile writer thread,
+/// which packs its tiles into it without touching the shared file offset.
+/// Only the owning thread advances 'next' while the encode is running.
+/// Under a positional write backend the tiles are staged and written in
+/// whole aligned blocks, so extents then begin and end block aligned.
+struct WriteExtent {
+    Offset          start       = 0;
+    Offset          end         = 0;
+    Offset          next        = 0;
+    WriteStage      stage;
+    atomic_uint64   written;    // Tile bytes below this are within the file
+    bool            retired     = false; // Left behind once a tile no longer fit
+    WriteExtent     (Offset __start, Offset __end, Offset __next) :
+    start           (__start),
+    end             (__end),
+    next            (__next),
+    written         (__next){}
+};
+/// Every write extent of an encode; the tails of the final extents (and of
+/// any extent above the lowest of them) are reclaimed once all tiles are written. The epoch invalidates the
+/// thread local extents a reused thread still holds from a previous encode.
+struct WriteExtentRegistry {
+    static constexpr size_t                     extent_size = 64ULL << 20;
+    Mutex                                       mutex;
+    std::list<WriteExtent>                      extents; // stable addresses
+    uint64_t                                    epoch       = 0;
 };
 struct EncoderTracker {
     using Layer                 = std::vector<TileTracker>;
@@ -133,9 +492,52 @@ struct EncoderTracker {
     uint32_t        total;
     Mutex           error_msg_mutex;
     std::string     error_msg;
+    UniformTileRegistry uniform;
+    TileHashRegistry    hashed;
+    WriteExtentRegistry writes;
+    Counter         shared;
+    atomic_uint64   shared_bytes;
+    std::atomic_bool interrupted;   // Stopped by interrupt_encoder, not a failure
     EncoderTracker  ():
     completed       (0),
-    total           (0){}
+    total           (0),
+    shared          (0),
+    shared_bytes    (0),
+    interrupted     (false){}
+};
+/// Journal of the tiles of an interrupted encode whose bytes are durably
+/// stored in its partial output file, and of the write extents holding them.
+/// It is only valid for the same source, destination, and every setting
+/// that changes the tile streams (encoding, quality, codec tuning, sharing).
+struct EncoderCheckpoint {
+    static constexpr uint32_t                   version     = 2;
+    struct Span {
+        Offset      start;
+        Offset      end;
+        Offset      written;
+    };
+    struct Tile {
+        uint32_t    layer;
+        uint32_t    index;
+        TileEntry   entry;
+    };
+    using Tiles                                 = std::vector<Tile>;
+    std::string                                 source;
+    std::string                                 destination;
+    std::string                                 partial;        // Temporary output file
+    uint64_t                                    sourceSize      = 0;
+    int64_t                                     sourceModified  = 0;
+    uint32_t                                    encoding        = 0;
+    uint32_t                                    derivation      = 0;
+    uint32_t                                    quality         = 0;
+    uint32_t                                    subsampling     = 0;
+    uint32_t                                    jpegOptimize    = 0;
+    uint32_t                                    avifSpeed       = 0;
+    uint32_t                                    avifAutoTiling  = 0;
+    uint32_t                                    deduplicate     = 0;
+    std::vector<std::pair<uint32_t, uint32_t>>  layers;         // x and y tiles
+    std::vector<Span>                           spans;
+    Tiles                                       tiles;          // In layer, tile order
 };
 struct DerivationInfo {
     using Queue                 = Async::ThreadPool;
@@ -0,0 +1,160 @@
+//
+//  IrisCodecSIMD.cpp
+//  Iris
+//
+//  Created by Ryan Landvater on 10/17/26.
+//
+#include "IrisCodecPriv.hpp"
+#include <hwy/highway.h>
+
+namespace IrisCodec {
+namespace hn = hwy::HWY_NAMESPACE;
+using ByteTag = hn::ScalableTag<uint8_t>;
+using ByteVec = hn::Vec<ByteTag>;
+inline uint32_t PIXEL_CHANNELS (Format format)
+{
+    switch (format) {
+        case Iris::FORMAT_UNDEFINED:    return 0;
+        case Iris::FORMAT_B8G8R8:
+        case Iris::FORMAT_R8G8B8:       return 3;
+        case Iris::FORMAT_B8G8R8A8:
+        case Iris::FORMAT_R8G8B8A8:     return 4;
+    }   return 0;
+}
+inline bool IS_BGR_ORDER (Format format)
+{
+    return  format == Iris::FORMAT_B8G8R8 ||
+            format == Iris::FORMAT_B8G8R8A8;
+}
+// Swap the red and blue channels of 3-channel pixels
+inline void HWY_ATTR SWAP_3 (const BYTE* src, BYTE* dst, size_t pixels)
+{
+    const ByteTag d;
+    const size_t N = hn::Lanes(d);
+    size_t p = 0;
+    for (; p + N <= pixels; p += N) {
+        ByteVec c0, c1, c2;
+        hn::LoadInterleaved3 (d, src + 3*p, c0, c1, c2);
+        hn::StoreInterleaved3(c2, c1, c0, d, dst + 3*p);
+    }
+    for (; p < pixels; ++p) {
+        const BYTE c0 = src[3*p], c1 = src[3*p+1], c2 = src[3*p+2];
+        dst[3*p] = c2; dst[3*p+1] = c1; dst[3*p+2] = c0;
+    }
+}
+// Swap the red and blue channels of 4-channel pixels, retaining alpha
+inline void HWY_ATTR SWAP_4 (const BYTE* src, BYTE* dst, size_t pixels)
+{
+    const ByteTag d;
+    const size_t N = hn::Lanes(d);
+    size_t p = 0;
+    for (; p + N <= pixels; p += N) {
+        ByteVec c0, c1, c2, c3;
+        hn::LoadInterleaved4 (d, src + 4*p, c0, c1, c2, c3);
+        hn::StoreInterleaved4(c2, c1, c0, c3, d, dst + 4*p);
+    }
+    for (; p < pixels; ++p) {
+        const BYTE c0 = src[4*p], c1 = src[4*p+1], c2 = src[4*p+2], c3 = src[4*p+3];
+        dst[4*p] = c2; dst[4*p+1] = c1; dst[4*p+2] = c0; dst[4*p+3] = c3;
+    }
+}
+// Drop the alpha channel. Walks forward so that the narrower destination
+// never overruns source pixels that have yet to be read when in place.
+template <bool swap>
+inline void HWY_ATTR DROP_ALPHA (const BYTE* src, BYTE* dst, size_t pixels)
+{
+    const ByteTag d;
+    const size_t N = hn::Lanes(d);
+    size_t p = 0;
+    for (; p + N <= pixels; p += N) {
+        ByteVec c0, c1, c2, c3;
+        hn::LoadInterleaved4 (d, src + 4*p, c0, c1, c2, c3);
+        if (swap) hn::StoreInterleaved3(c2, c1, c0, d, dst + 3*p);
+        else      hn::StoreInterleaved3(c0, c1, c2, d, dst + 3*p);
+    }
+    for (; p < pixels; ++p) {
+        const BYTE c0 = src[4*p], c1 = src[4*p+1], c2 = src[4*p+2];
+        dst[3*p]    = swap ? c2 : c0;
+        dst[3*p+1]  = c1;
+        dst[3*p+2]  = swap ? c0 : c2;
+    }
+}
+// Add an opaque alpha channel. Walks backward so that the wider destination
+// never overwrites source pixels that have yet to be read when in place.
+template <bool swap>
+inline void HWY_ATTR FILL_ALPHA (const BYTE* src, BYTE* dst, size_t pixels)
+{
+    const ByteTag d;
+    const size_t N = hn::Lanes(d);
+    const ByteVec alpha = hn::Set(d, 0xFF);
+    size_t p = pixels;
+    for (const size_t vectors = pixels - pixels % N; p > vectors;) {
+        --p;
+        const BYTE c0 = src[3*p], c1 = src[3*p+1], c2 = src[3*p+2];
+        dst[4*p]    = swap ? c2 : c0;
+        dst[4*p+1]  = c1;
+        dst[4*p+2]  = swap ? c0 : c2;
+        dst[4*p+3]  = 0xFF;
+    }
+    while (p) {
+        p -= N;
+        ByteVec c0, c1, c2;
+        hn::LoadInterleaved3 (d, src + 3*p, c0, c1, c2);
+        if (swap) hn::StoreInterleaved4(c2, c1, c0, alpha, d, dst + 4*p);
+        else      hn::StoreInterleaved4(c0, c1, c2, alpha, d, dst + 4*p);
+    }
+}
+void convert_pixel_format (const PixelConvertInfo &info)
+{
+    const auto src_channels = PIXEL_CHANNELS(info.initial);
+    const auto dst_channels = PIXEL_CHANNELS(info.desired);
+    if (!src_channels || !dst_channels) throw std::runtime_error
+        ("convert_pixel_format requires defined initial and desired pixel formats");
+    if (!info.source || !info.destination) throw std::runtime_error
+        ("convert_pixel_format requires valid source and destination pointers");
+
+    const bool swap = IS_BGR_ORDER(info.initial) != IS_BGR_ORDER(info.desired);
+    if (src_channels == dst_channels) {
+        if (swap && src_channels == 3)
+            SWAP_3(info.source, info.destination, info.pixels);
+        else if (swap)
+            SWAP_4(info.source, info.destination, info.pixels);
+        else if (info.source != info.destination)
+            memmove(info.destination, info.source, info.pixels * src_channels);
+    }
+    else if (src_channels == 4) {
+        if (swap)   DROP_ALPHA<true> (info.source, info.destination, info.pixels);
+        else        DROP_ALPHA<false>(info.source, info.destination, info.pixels);
+    }
+    else {
+        if (swap)   FILL_ALPHA<true> (info.source, info.destination, info.pixels);
+        else        FILL_ALPHA<false>(info.source, info.destination, info.pixels);
+    }
+}
+bool is_uniform_pixels (const BYTE* pixels, size_t pixel_count, Format format)
+{
+    const auto channels = PIXEL_CHANNELS(format);
+    if (!channels) throw std::runtime_error
+        ("is_uniform_pixels requires a defined pixel format");
+    if (pixel_count < 2) return true;
+    
+    // Every pixel matches the first if and only if every byte matches the
+    // byte one pixel later; this holds for 3 and 4 byte pixels alike and
+    // needs no channel shuffles.
+    const ByteTag d;
+    const size_t N      = hn::Lanes(d);
+    const size_t bytes  = (pixel_count - 1) * channels;
+    const BYTE*  next   = pixels + channels;
+    size_t i = 0;
+    for (; i + 4*N <= bytes; i += 4*N) {
+        auto diff = hn::Xor(hn::LoadU(d, pixels + i),       hn::LoadU(d, next + i));
+        diff = hn::Or(diff, hn::Xor(hn::LoadU(d, pixels + i + N),   hn::LoadU(d, next + i + N)));
+        diff = hn::Or(diff, hn::Xor(hn::LoadU(d, pixels + i + 2*N), hn::LoadU(d, next + i + 2*N)));
+        diff = hn::Or(diff, hn::Xor(hn::LoadU(d, pixels + i + 3*N), hn::LoadU(d, next + i + 3*N)));
+        if (!hn::AllTrue(d, hn::Eq(diff, hn::Zero(d)))) return false;
+    }
+    for (; i < bytes; ++i)
+        if (pixels[i] != next[i]) return false;
+    return true;
+}
+} // END IRIS CODEC NAMESPACE
@@ -5,6 +5,13 @@
 //  Created by Ryan Landvater on 1/9/24.
 //
 #include <assert.h>
+#include <cmath>
+#include <chrono>
+#include <map>
+#include <tuple>
+#if !_WIN32
+#include <sys/stat.h>
+#endif
 #include "IrisCodecPriv.hpp"
 
 namespace IrisCodec {
@@ -19,6 +26,156 @@ inline File OPEN_FILE (const SlideOpenInfo& info)
     
     return file;
 }
+inline Offset LOAD_SLIDE_STRUCTURE (const File& file)
+{
+    // Block cached slide files are not mapped. The header, the tile table
+    // block and every byte from the first structural block either of them
+    // references to the end of the file are loaded into the file image to be
+    // parsed in place; tile data and associated image bytes go through the
+    // block cache. Returns the start of the loaded structure, against which
+    // the parsers check every block offset they follow.
+    using namespace Serialization;
+    auto LOAD = [&file](Offset offset, Size size) {
+        if (offset > file->size || size > file->size - offset) throw std::runtime_error
+            ("file structure block offset (" + std::to_string(offset) + ") is out of bounds");
+        auto result = load_file_range(file, FileRange {offset, size});
+        if (result != IRIS_SUCCESS) throw std::runtime_error(result.message);
+    };
+    if (file->size < FILE_HEADER::header_size)
+        throw std::runtime_error("file is too small to contain an Iris file header");
+    LOAD(0, FILE_HEADER::header_size);
+    
+    const FILE_HEADER bootstrap {file->ptr, 0, file->size, UINT32_MAX};
+    const auto table = bootstrap.tile_table_offset();
+    LOAD(table.__offset, TILE_TABLE::header_size);
+    
+    const Offset start = std::min({
+        table.__offset,
+        table.tile_offsets_offset().__offset,
+        table.layer_extents_offset().__offset,
+        bootstrap.metadata_offset().__offset,
+    });
+    if (start < FILE_HEADER::header_size)
+        throw std::runtime_error("file header block offsets are out of bounds");
+    LOAD(start, file->size - start);
+    return start;
+}
+// MARK: - SHARED SLIDE FILES
+// Files are identified by device, inode, size and modification time so that
+// a replaced or rewritten slide file is never served from a stale mapping,
+// and by the options that shape how they are read so that a slide is only
+// handed a file opened the way it asked for.
+struct SlideFileKey {
+    uint64_t                                    device      = 0;
+    uint64_t                                    inode       = 0;
+    uint64_t                                    size        = 0;
+    int64_t                                     modified    = 0;    // ns
+    FileReadBackend                             backend     = FILE_READ_MAPPED;
+    bool                                        populate    = false;
+    FileAccessAdvice                            access      = FILE_ACCESS_NORMAL;
+    bool                                        hugePages   = false;
+    size_t                                      cacheBytes  = 0;
+    bool operator < (const SlideFileKey& __o) const {
+        return  std::tie(device, inode, size, modified, backend,
+                         populate, access, hugePages, cacheBytes) <
+                std::tie(__o.device, __o.inode, __o.size, __o.modified, __o.backend,
+                         __o.populate, __o.access, __o.hugePages, __o.cacheBytes);
+    }
+};
+inline void KEY_SLIDE_FILE_OPTIONS (SlideFileKey& key, FileReadBackend backend,
+                                    const FileMappingOptions& mapping, size_t cacheBytes)
+{
+    // Mapping options only shape mapped files and the block cache budget
+    // only block cached ones; the other is left out of the key.
+    key.backend = backend;
+    switch (backend) {
+        case FILE_READ_MAPPED:
+            key.populate    = mapping.populate;
+            key.access      = mapping.access;
+            key.hugePages   = mapping.hugePages;
+            break;
+        case FILE_READ_BLOCK_CACHE:
+            key.cacheBytes  = cacheBytes;
+            break;
+    }
+}
+struct SlideFileRegistry {
+    Mutex                                                   mutex;
+    std::map<SlideFileKey, std::weak_ptr<__INTERNAL__SlideFile>> files;
+};
+inline SlideFileRegistry& SLIDE_FILE_REGISTRY ()
+{
+    static SlideFileRegistry registry;
+    return registry;
+}
+#if _WIN32
+// Windows stat reports no inode numbers; slide files are not shared there.
+inline bool GET_SLIDE_FILE_KEY (const std::string&, SlideFileKey&) {return false;}
+inline bool GET_SLIDE_FILE_KEY (const File&, SlideFileKey&) {return false;}
+#else
+inline SlideFileKey SLIDE_FILE_KEY (const struct stat& info)
+{
+    #if __APPLE__
+    const auto& modified = info.st_mtimespec;
+    #else
+    const auto& modified = info.st_mtim;
+    #endif
+    return SlideFileKey {
+        .device     = static_cast<uint64_t>(info.st_dev),
+        .inode      = static_cast<uint64_t>(info.st_ino),
+        .size       = static_cast<uint64_t>(info.st_size),
+        .modified   = static_cast<int64_t>(modified.tv_sec) * 1000000000LL + modified.tv_nsec,
+    };
+}
+inline bool GET_SLIDE_FILE_KEY (const std::string& path, SlideFileKey& key)
+{
+    struct stat info;
+    if (stat(path.c_str(), &info) == -1) return false;
+    key = SLIDE_FILE_KEY(info);
+    return true;
+}
+inline bool GET_SLIDE_FILE_KEY (const File& file, SlideFileKey& key)
+{
+    // Key the file actually opened and mapped rather than the path, which
+    // may have been replaced since it was looked up.
+    struct stat info;
+    if (fstat(fileno(file->handle), &info) == -1) return false;
+    key = SLIDE_FILE_KEY(info);
+    return true;
+}
+#endif
+inline SlideFile FIND_SHARED_SLIDE_FILE (const std::string& path, const SlideOpenOptions& options)
+{
+    SlideFileKey key;
+    if (GET_SLIDE_FILE_KEY(path, key) == false) return NULL;
+    KEY_SLIDE_FILE_OPTIONS(key, options.readBackend, options.mapping, options.blockCacheBytes);
+    
+    auto& registry = SLIDE_FILE_REGISTRY();
+    MutexLock __ (registry.mutex);
+    auto entry = registry.files.find(key);
+    return entry == registry.files.end() ? NULL : entry->second.lock();
+}
+inline SlideFile SHARE_SLIDE_FILE (const SlideFile& slide_file)
+{
+    SlideFileKey key;
+    const auto& file = slide_file->file;
+    if (GET_SLIDE_FILE_KEY(file, key) == false) return slide_file;
+    KEY_SLIDE_FILE_OPTIONS(key, file->cache ? FILE_READ_BLOCK_CACHE : FILE_READ_MAPPED,
+                           file->mapping, file->cache ? file->cache->budget : 0);
+    
+    auto& registry = SLIDE_FILE_REGISTRY();
+    MutexLock __ (registry.mutex);
+    auto& entry = registry.files[key];
+    // Another session may have opened the same file concurrently; use theirs
+    if (auto existing = entry.lock()) return existing;
+    entry = slide_file;
+    
+    // Drop the entries of slide files no longer open anywhere
+    std::erase_if(registry.files, [](const auto& __e) {
+        return __e.second.expired();
+    });
+    return slide_file;
+}
 Iris::Result is_iris_codec_file(const std::string &file_path) noexcept
 {
     try {
@@ -58,7 +215,7 @@ Iris::Result validate_slide (const struct SlideOpenInfo &info) noexcept
         auto file = open_file(file_info);
         if (file == nullptr) throw std::runtime_error("file path is not a valid file\n");
         
-        ReadLock read_lock (file->resize);
+        auto read_lock = file->read_lock();
         return validate_file_structure({file->ptr, file->size});
         
     } catch (std::runtime_error &e) {
@@ -70,7 +227,40 @@ Iris::Result validate_slide (const struct SlideOpenInfo &info) noexcept
         );
     }
 }
+Iris::Result validate_slide (const struct SlideOpenInfo &info,
+                             const SlideValidationOptions &options,
+                             SlideValidationReport &report) noexcept
+{
+    auto result = validate_slide(info);
+    if (result != IRIS_SUCCESS) return result;
+    try {
+        auto slide = open_slide(info);
+        if (slide == nullptr) throw std::runtime_error("the slide could not be opened\n");
+        
+        report = slide->validate_slide_tiles(options);
+        if (report.tilesFailed) return Iris::Result (
+            IRIS_FAILURE,
+            "Iris File Extension slide (" +
+            info.filePath + ") failed deep validation: " +
+            std::to_string(report.tilesFailed) + " of " +
+            std::to_string(report.tilesChecked) + " tiles failed to decode\n"
+        );
+        return IRIS_SUCCESS;
+        
+    } catch (std::runtime_error &e) {
+        return Iris::Result (
+            IRIS_FAILURE,
+            "Iris File Extension slide (" +
+            info.filePath + ") failed deep validation: " +
+            e.what () + "\n"
+        );
+    }
+}
 Slide open_slide (const struct SlideOpenInfo &info) noexcept
+{
+    return open_slide(info, SlideOpenOptions {});
+}
+Slide open_slide (const struct SlideOpenInfo &info, const SlideOpenOptions &options) noexcept
 {
     try {
         // Create a context if not provided
@@ -82,18 +272,32 @@ Slide open_slide (const struct SlideOpenInfo &info) noexcept
         if (context == nullptr) 
             throw std::runtime_error("No valid context");
         
-        // Open the file
-        FileOpenInfo file_info {
-            .filePath       = info.filePath,
-            .writeAccess    = false,
-        };
-        auto file = open_file(file_info);
-        if (file == nullptr)
-            throw std::runtime_error("no valid file opened.");
+        // Share the mapping and tile table of the file if it is already
+        // open elsewhere in the process
+        SlideFile shared = options.share ?
+        FIND_SHARED_SLIDE_FILE(info.filePath, options) : NULL;
+        if (shared == nullptr) {
+            // Open the file
+            FileOpenInfo file_info {
+                .filePath       = info.filePath,
+                .writeAccess    = false,
+                .mapping        = options.mapping,
+                .readBackend    = options.readBackend,
+                .blockCacheBytes= options.blockCacheBytes,
+            };
+            auto file = open_file(file_info);
+            if (file == nullptr)
+                throw std::runtime_error("no valid file opened.");
+            const Offset structure = file->cache ? LOAD_SLIDE_STRUCTURE(file) : 0;
+            
+            // Index the tile table
+            auto read_lock = file->read_lock();
+            shared = std::make_shared<__INTERNAL__SlideFile>(file, structure);
+            if (options.share) shared = SHARE_SLIDE_FILE(shared);
+        }
         
         // Create the slide object
-        ReadLock read_lock (file->resize);
-        Slide slide = std::make_shared<__INTERNAL__Slide>(context,file);
+        Slide slide = std::make_shared<__INTERNAL__Slide>(context,shared);
         if (slide == nullptr) throw std::runtime_error ("Failed to create slide object");
         
         // Return the slide
@@ -122,6 +326,22 @@ Iris::Result get_slide_info(const Slide &slide, SlideInfo& info) noexcept
         };
     }   return IRIS_FAILURE;
 }
+Iris::Result get_slide_extent(const Slide &slide, Extent& extent) noexcept
+{
+    try {
+        if (!slide)
+            throw std::runtime_error("no valid slide object");
+        
+        extent = slide->get_slide_extent();
+        
+        return IRIS_SUCCESS;
+    } catch (std::runtime_error& e) {
+        return  {
+            IRIS_FAILURE,
+            std::string("Failed to read slide extent: ") + e.what()
+        };
+    }   return IRIS_FAILURE;
+}
 Buffer read_slide_tile(const SlideTileReadInfo &info) noexcept
 {
     try {
@@ -141,6 +361,192 @@ Buffer read_slide_tile(const SlideTileReadInfo &info) noexcept
         return NULL;
     }   return NULL;
 }
+Buffer read_slide_tile(const SlideTileReadInfo &info, DecodeScale scale) noexcept
+{
+    try {
+        // Ensure the slide object is valid
+        if (info.slide == NULL)
+            throw std::runtime_error("No valid codec slide object");
+        
+        // Read the slide tile at the requested scale
+        auto result = info.slide->read_slide_tile(info, scale);
+        return result;
+        
+    } catch (std::runtime_error& e) {
+        std::cerr << "Failed to read the scaled slide tile"
+                    << "[layer " << info.layerIndex
+                    << ", tile " << info.tileIndex
+                    << ", scale 1/" << static_cast<int>(scale)
+                    << "]: " << e.what() << "\n";
+        return NULL;
+    }   return NULL;
+}
+SlideTileReadResults read_slide_tiles(const SlideTilesReadInfo &info) noexcept
+{
+    try {
+        // Ensure the slide object is valid
+        if (info.slide == NULL)
+            throw std::runtime_error("No valid codec slide object");
+        
+        // Read the slide tiles
+        return info.slide->read_slide_tiles(info);
+        
+    } catch (std::runtime_error& e) {
+        std::cerr << "Failed to read the slide tiles"
+                    << "[layer " << info.layerIndex
+                    << ", " << info.tileIndices.size()
+                    << " tiles]: " << e.what() << "\n";
+        
+        // Report the batch level failure against every requested tile
+        SlideTileReadResults results (info.tileIndices.size());
+        for (size_t index = 0; index < results.size(); ++index) {
+            results[index].tileIndex = info.tileIndices[index];
+            results[index].result    = Result (
+                IRIS_FAILURE,
+                std::string("Failed to read the slide tiles: ") + e.what()
+            );
+        }
+        return results;
+    }
+}
+Buffer read_slide_region(const SlideRegionReadInfo &info) noexcept
+{
+    try {
+        // Ensure the slide object is valid
+        if (info.slide == NULL)
+            throw std::runtime_error("No valid codec slide object");
+        
+        // Read the slide region
+        return info.slide->read_slide_region(info);
+        
+    } catch (std::runtime_error& e) {
+        std::cerr << "Failed to read the slide region"
+                    << "[layer " << info.layerIndex
+                    << ", origin (" << info.xOffset << "," << info.yOffset
+                    << "), size (" << info.width << "x" << info.height
+                    << ")]: " << e.what() << "\n";
+        return NULL;
+    }   return NULL;
+}
+Result prefetch_slide_tiles(const SlidePrefetchInfo &info) noexcept
+{
+    try {
+        if (!info.slide)
+            throw std::runtime_error("no valid slide object");
+        
+        info.slide->prefetch_slide_tiles(info.layerIndex, info.tileIndices);
+        
+        return IRIS_SUCCESS;
+    } catch (std::runtime_error& e) {
+        return  {
+            IRIS_FAILURE,
+            std::string("Failed to prefetch slide tiles: ") + e.what()
+        };
+    }   return IRIS_FAILURE;
+}
+Result prefetch_slide_region(const SlideRegionReadInfo &info) noexcept
+{
+    try {
+        if (!info.slide)
+            throw std::runtime_error("no valid slide object");
+        
+        info.slide->prefetch_slide_region(info);
+        
+        return IRIS_SUCCESS;
+    } catch (std::runtime_error& e) {
+        return  {
+            IRIS_FAILURE,
+            std::string("Failed to prefetch slide region: ") + e.what()
+        };
+    }   return IRIS_FAILURE;
+}
+Result evict_slide_layer(const Slide &slide, uint32_t layerIndex) noexcept
+{
+    try {
+        if (!slide)
+            throw std::runtime_error("no valid slide object");
+        
+        slide->evict_slide_layer(layerIndex);
+        
+        return IRIS_SUCCESS;
+    } catch (std::runtime_error& e) {
+        return  {
+            IRIS_FAILURE,
+            std::string("Failed to evict slide layer: ") + e.what()
+        };
+    }   return IRIS_FAILURE;
+}
+Result set_slide_tile_cache_budget(const Slide &slide, size_t bytes) noexcept
+{
+    try {
+        if (!slide)
+            throw std::runtime_error("no valid slide object");
+        
+        slide->set_tile_cache_budget(bytes);
+        
+        return IRIS_SUCCESS;
+    } catch (std::runtime_error& e) {
+        return  {
+            IRIS_FAILURE,
+            std::string("Failed to set the slide tile cache budget: ") + e.what()
+        };
+    }   return IRIS_FAILURE;
+}
+Result get_slide_tile_cache_stats(const Slide &slide, TileCacheStats &stats) noexcept
+{
+    try {
+        if (!slide)
+            throw std::runtime_error("no valid slide object");
+        
+        stats = slide->get_tile_cache_stats();
+        
+        return IRIS_SUCCESS;
+    } catch (std::runtime_error& e) {
+        return  {
+            IRIS_FAILURE,
+            std::string("Failed to read the slide tile cache stats: ") + e.what()
+        };
+    }   return IRIS_FAILURE;
+}
+Result get_slide_tile_view(const Slide &slide, uint32_t layer, uint32_t tile, MappedView &view) noexcept
+{
+    try {
+        if (!slide) throw std::runtime_error
+            ("No valid codec slide object");
+        
+        view = slide->get_slide_tile_view(layer, tile);
+        return IRIS_SUCCESS;
+        
+    } catch (std::runtime_error& e) {
+        view = MappedView();
+        return {
+            IRIS_FAILURE,
+            "Failed to get view of slide tile [layer " +
+            std::to_string(layer) + ", tile " + std::to_string(tile) +
+            "]: " + e.what()
+        };
+    }   return IRIS_FAILURE;
+}
+Result get_associated_image_view(const Slide &slide, const std::string &image_label, MappedView &view) noexcept
+{
+    try {
+        if (!slide) throw std::runtime_error
+            ("No valid codec slide object");
+        if (!image_label.size()) throw std::runtime_error
+            ("No image label provided");
+        
+        view = slide->get_assoc_image_view(image_label);
+        return IRIS_SUCCESS;
+        
+    } catch (std::runtime_error& e) {
+        view = MappedView();
+        return {
+            IRIS_FAILURE,
+            std::string("Failed to get view of associated image: ") +
+            e.what()
+        };
+    }   return IRIS_FAILURE;
+}
 Result get_associated_image_info(const Slide &slide, AssociatedImageInfo &info) noexcept
 {
     try {
@@ -210,12 +616,158 @@ Iris::Result get_slide_annotations(const Slide &slide, Annotations &annotations)
         };
     }   return IRIS_FAILURE;
 }
-__INTERNAL__Slide::__INTERNAL__Slide    (const Context& cxt, const File& file) :
+inline uint32_t LOAD_U32_LE (const BYTE* ptr)
+{
+    return  static_cast<uint32_t>(ptr[0])       |
+            static_cast<uint32_t>(ptr[1]) << 8  |
+            static_cast<uint32_t>(ptr[2]) << 16 |
+            static_cast<uint32_t>(ptr[3]) << 24;
+}
+inline uint64_t LOAD_U64_LE (const BYTE* ptr)
+{
+    return  static_cast<uint64_t>(LOAD_U32_LE(ptr)) |
+            static_cast<uint64_t>(LOAD_U32_LE(ptr + 4)) << 32;
+}
+inline __INTERNAL__TileTableIndex INDEX_TILE_TABLE (const File& file, Offset structure)
+{
+    using namespace Serialization;
+    const BYTE* __base  = file->ptr;
+    const Size  __size  = file->size;
+    if (__base == nullptr || __size < FILE_HEADER::header_size)
+        throw std::runtime_error("file is too small to contain an Iris file header");
+    
+    // Block cached files hold only the header and [structure, EOF) in memory.
+    // A block outside of that range would parse as zeros rather than fail.
+    auto CHECK_LOADED = [structure, __size](Offset offset, Size size, const char* block) {
+        if (offset < structure || offset > __size || size > __size - offset)
+            throw std::runtime_error(std::string(block) + " block (offset " +
+                                     std::to_string(offset) + ") lies outside of the loaded slide structure");
+    };
+    
+    // Bootstrap the extension version with every version gate open, then
+    // rebuild the header handle at the version the file declares.
+    const FILE_HEADER bootstrap {__base, 0, __size, UINT32_MAX};
+    const uint32_t version = (static_cast<uint32_t>(bootstrap.extension_major()) << 16)
+                           | bootstrap.extension_minor();
+    const FILE_HEADER header {__base, 0, __size, version};
+    if (!header.validate()) throw std::runtime_error
+        ("file header failed validation");
+    
+    // Validate only the structural blocks the tile table index reads. The
+    // TILE_OFFSETS block validation bounds every entry within the file.
+    const auto table    = header.tile_table_offset();
+    CHECK_LOADED(table.__offset, TILE_TABLE::header_size, "tile table");
+    if (!table.validate()) throw std::runtime_error
+        ("tile table failed validation");
+    const auto extents  = table.layer_extents_offset();
+    CHECK_LOADED(extents.__offset, LAYER_EXTENTS::header_size, "layer extents");
+    if (!extents.validate()) throw std::runtime_error
+        ("layer extents failed validation");
+    CHECK_LOADED(extents.__offset, LAYER_EXTENTS::header_size + static_cast<Size>(extents.count()) *
+                 LAYER_EXTENTS::LAYER_EXTENT::entry_size, "layer extents");
+    const auto offsets  = table.tile_offsets_offset();
+    CHECK_LOADED(offsets.__offset, TILE_OFFSETS::header_size, "tile offsets");
+    if (!offsets.validate()) throw std::runtime_error
+        ("tile offsets failed validation");
+    CHECK_LOADED(offsets.__offset, TILE_OFFSETS::header_size + static_cast<Size>(offsets.count()) *
+                 TILE_OFFSETS::TILE_OFFSET::entry_size, "tile offsets");
+    
+    __INTERNAL__TileTableIndex index {
+        .encoding   = static_cast<Encoding>(table.encoding()),
+        .format     = static_cast<Format>(table.format()),
+        .extent     = Extent {
+            .width  = table.x_extent(),
+            .height = table.y_extent(),
+        },
+        .entries    = offsets.__offset + TILE_OFFSETS::header_size,
+    };
+    
+    // Read the layer extents. Each entry leads with X_TILES (u32),
+    // Y_TILES (u32) and SCALE (f32); later revisions only append fields.
+    const uint32_t layer_count = extents.count();
+    const BYTE* extent_ptr = __base + extents.__offset + LAYER_EXTENTS::header_size;
+    index.extent.layers.resize(layer_count);
+    index.layerFirst.resize(layer_count + 1);
+    uint64_t total = 0;
+    for (uint32_t layer = 0; layer < layer_count; ++layer) {
+        const BYTE* entry = extent_ptr + layer * LAYER_EXTENTS::LAYER_EXTENT::entry_size;
+        auto& extent      = index.extent.layers[layer];
+        extent.xTiles     = LOAD_U32_LE(entry);
+        extent.yTiles     = LOAD_U32_LE(entry + 4);
+        const uint32_t scale_bits = LOAD_U32_LE(entry + 8);
+        memcpy(&extent.scale, &scale_bits, sizeof(float));
+        index.layerFirst[layer] = total;
+        total += static_cast<uint64_t>(extent.xTiles) * extent.yTiles;
+    }
+    index.layerFirst[layer_count] = total;
+    for (auto& extent : index.extent.layers)
+        extent.downsample = index.extent.layers.back().scale / extent.scale;
+    
+    // The flat offsets array must hold exactly one entry per layer tile
+    if (total != offsets.count()) throw std::runtime_error
+        ("tile offsets entry count (" + std::to_string(offsets.count()) +
+         ") does not match the layer extents tile count (" + std::to_string(total) + ")");
+    
+    return index;
+}
+__INTERNAL__SlideFile::__INTERNAL__SlideFile (const File& __file, Offset __structure) :
+file                                    (__file),
+structure                               (__structure),
+tileTable                               (INDEX_TILE_TABLE(__file, __structure))
+{
+    
+}
+__INTERNAL__Slide::__INTERNAL__Slide    (const Context& cxt, const SlideFile& shared) :
 _context                                (cxt),
-_file                                   (file),
-_abstraction                            (abstract_file_structure({file->ptr, file->size}))
+_shared                                 (shared),
+_file                                   (shared->file),
+_tileTable                              (shared->tileTable),
+_tileCache                              (cxt ? cxt->get_tile_cache_budget() : 0)
 {
     
+}
+Abstraction::TileEntry __INTERNAL__Slide::get_tile_entry(uint32_t layer, uint32_t tile_indx) const
+{
+    // Check that the layer in within the table
+    auto& first = _tileTable.layerFirst;
+    if (layer + 1 >= first.size()) throw std::runtime_error
+        ("layer index (" + std::to_string(layer) + ") is out of bounds");
+    
+    // Check that the tile is within the layer
+    const uint64_t index = first[layer] + tile_indx;
+    if (index >= first[layer + 1]) throw std::runtime_error
+        ("tile index (" + std::to_string(tile_indx) + ") is out of layer " +
+         std::to_string(layer) + " bounds");
+    
+    // Each TILE_OFFSETS entry packs a 40-bit offset and a 24-bit byte size
+    using namespace Serialization;
+    const uint64_t packed = LOAD_U64_LE(_file->ptr + _tileTable.entries +
+                                        index * TILE_OFFSETS::TILE_OFFSET::entry_size);
+    Abstraction::TileEntry entry;
+    entry.offset    = packed & 0xFFFFFFFFFFULL;
+    entry.size      = static_cast<uint32_t>(packed >> 40);
+    return entry;
+}
+const Abstraction::File& __INTERNAL__Slide::get_abstraction() const
+{
+    auto& shared = *_shared;
+    std::call_once(shared.abstracted, [this, &shared](){
+        auto lock = _file->read_lock();
+        
+        // Block cached files hold only their loaded structure in memory.
+        // Validate every block first so that one laid out before it fails
+        // rather than abstracting as zeros.
+        if (_file->cache) {
+            auto result = validate_file_structure({_file->ptr, _file->size});
+            if (result != IRIS_SUCCESS) throw std::runtime_error(result.message);
+        }
+        shared.abstraction = abstract_file_structure({_file->ptr, _file->size});
+        
+        // Tile lookups are served by the in-place tile table index; do not
+        // keep a second, fully materialized copy of every tile entry.
+        Abstraction::TileTable::Layers().swap(shared.abstraction.tileTable.layers);
+    });
+    return shared.abstraction;
 }
 __INTERNAL__Slide::~__INTERNAL__Slide   ()
 {
@@ -224,60 +776,77 @@ __INTERNAL__Slide::~__INTERNAL__Slide   ()
 
 Version __INTERNAL__Slide::get_slide_codec_version() const
 {
-    return _abstraction.metadata.codec;
+    return get_abstraction().metadata.codec;
 }
 SlideInfo __INTERNAL__Slide::get_slide_info() const
 {
     return SlideInfo {
-        .format         = _abstraction.tileTable.format,
-        .encoding       = _abstraction.tileTable.encoding,
-        .extent         = _abstraction.tileTable.extent,
-        .metadata       = _abstraction.metadata,
+        .format         = _tileTable.format,
+        .encoding       = _tileTable.encoding,
+        .extent         = _tileTable.extent,
+        .metadata       = get_abstraction().metadata,
     };
 }
+const Extent& __INTERNAL__Slide::get_slide_extent() const
+{
+    return _tileTable.extent;
+}
+Format __INTERNAL__Slide::get_slide_format() const
+{
+    return _tileTable.format;
+}
+Encoding __INTERNAL__Slide::get_slide_encoding() const
+{
+    return _tileTable.encoding;
+}
+Buffer __INTERNAL__Slide::get_file_bytes(Offset offset, Size size) const
+{
+    Buffer bytes;
+    auto result = read_file_range(_file, FileRange {offset, size}, bytes);
+    if (result != IRIS_SUCCESS) throw std::runtime_error(result.message);
+    return bytes;
+}
+Buffer __INTERNAL__Slide::get_tile_bytes(const Abstraction::TileEntry& entry) const
+{
+    return get_file_bytes(entry.offset, entry.size);
+}
 Buffer __INTERNAL__Slide::get_slide_tile_entry(uint32_t layer, uint32_t tile_indx) const
 {
-    ReadLock lock (_file->resize);
-    
-    // Pull the extent and check that the layer in within info
-    auto& ttable = _abstraction.tileTable;
-    auto& layers = ttable.layers;
-    if (layer >= layers.size())
-        throw std::runtime_error("layer in SlideTileReadInfo is out of bounds");
-    
-    // Pull the layer extent and check that the tile is within info
-    auto& tiles = layers[layer];
-    if (tile_indx >= tiles.size())
-        throw std::runtime_error("tile in SLideTileReadInfo is out of layer bounds");
+    auto lock = _file->read_lock();
     
     // Get the offset and size of the tile entry
-    auto& entry     = tiles[tile_indx];
-    return Iris::Copy_strong_buffer_from_data(_file->ptr + entry.offset, entry.size);
+    const auto entry = get_tile_entry(layer, tile_indx);
+    auto bytes = get_tile_bytes(entry);
+    // Block cached reads are already an owned copy
+    if (_file->cache) return bytes;
+    return Iris::Copy_strong_buffer_from_data(bytes->data(), bytes->size());
 }
-Buffer __INTERNAL__Slide::read_slide_tile(const SlideTileReadInfo &info) const
+MappedView __INTERNAL__Slide::get_slide_tile_view(uint32_t layer, uint32_t tile_indx) const
 {
-    ReadLock lock (_file->resize);
-    
-    // Pull the extent and check that the layer in within info
-    auto& ttable = _abstraction.tileTable;
-    auto& layers = ttable.layers;
-    if (info.layerIndex >= layers.size())
-        throw std::runtime_error("layer in SlideTileReadInfo is out of bounds");
-    
-    // Pull the layer extent and check that the tile is within info
-    auto& tiles = layers[info.layerIndex];
-    if (info.tileIndex >= tiles.size())
-        throw std::runtime_error("tile in SLideTileReadInfo is out of layer bounds");
+    // The lease holds the resize lock for as long as the view is alive
+    auto lease = std::make_shared<__INTERNAL__FileLock>(_file);
     
+    // (block cached files return an owned copy; the lease is then moot)
+    const auto entry = get_tile_entry(layer, tile_indx);
+    return MappedView {
+        .bytes  = get_tile_bytes(entry),
+        .offset = entry.offset,
+        .lease  = lease,
+    };
+}
+Buffer __INTERNAL__Slide::decompress_slide_tile(uint32_t layer, uint32_t tile_indx,
+                                                Format format, const Buffer& destination,
+                                                size_t offset, size_t pitch,
+                                                DecodeScale scale) const
+{
     // Get the offset and size of the tile entry
-    auto& entry     = tiles[info.tileIndex];
-    Buffer src      = Iris::Wrap_weak_buffer_fom_data (_file->ptr + entry.offset, entry.size);
+    const auto entry = get_tile_entry(layer, tile_indx);
     
     
     // Initialize the write destination
     Buffer dst_buffer   = nullptr;
     size_t dst_size     = 0;
-    switch (info.desiredFormat) {
+    switch (format) {
         case FORMAT_UNDEFINED: throw std::runtime_error
             ("desired format in SLideTileReadInfo is undefined");
         case Iris::FORMAT_B8G8R8:
@@ -290,31 +859,380 @@ Buffer __INTERNAL__Slide::read_slide_tile(const SlideTileReadInfo &info) const
             break;
     } if (!dst_size) throw std::runtime_error
         ("invalid desired slide format in SlideTileReadInfo");
+    if (scale != DECODE_SCALE_FULL && (offset || pitch)) throw std::runtime_error
+        ("Scaled slide tiles cannot be decoded into a pitched destination");
+    dst_size           /= scale * scale;
     
     // Check to see if there is a destination provided to write into, and if that
     // destination buffer is sufficiently large to hold the unpacked data.
-    if (info.optionalDestination && info.optionalDestination->capacity() >= dst_size)
-            dst_buffer = info.optionalDestination;
+    // Pitched writes land inside a caller owned image and are always in place.
+    if (offset || pitch)
+            dst_buffer = destination;
+    else if (destination && destination->capacity() >= dst_size)
+            dst_buffer = destination;
     else    dst_buffer = Iris::Create_strong_buffer(dst_size);
     
+    // Serve the tile from the decoded tile cache if it is present
+    const auto cache_key = __INTERNAL__TileCache::make_key(layer, tile_indx, format, scale);
+    const bool cache_on  = _tileCache.enabled();
+    if (cache_on && dst_buffer) {
+        if (!(offset || pitch)) dst_buffer->set_size(dst_size);
+        if (_tileCache.read(cache_key, static_cast<BYTE*>(dst_buffer->data()) + offset, pitch))
+            return dst_buffer;
+    }
+    
     // Return the decompressed file structure
+    Buffer src      = get_tile_bytes(entry);
     dst_buffer = _context->decompress_tile({
         .compressed             = src,
         .optionalDestination    = dst_buffer,
-        .desiredFormat          = info.desiredFormat,
-        .encoding               = ttable.encoding,
+        .desiredFormat          = format,
+        .encoding               = _tileTable.encoding,
+        .destinationOffset      = offset,
+        .rowPitch               = pitch,
+        .scale                  = scale,
     });
     if (!dst_buffer) throw std::runtime_error
         ("Failed to decompress slide tile");
     
+    // Retain a tightly packed copy of the decoded tile in the cache
+    if (cache_on) {
+        const size_t row_bytes = dst_size / (TILE_PIX_LENGTH / scale);
+        const BYTE*  src_ptr   = static_cast<const BYTE*>(dst_buffer->data()) + offset;
+        Buffer cached = Iris::Create_strong_buffer(dst_size);
+        cached->set_size(dst_size);
+        if (pitch == 0 || pitch == row_bytes)
+            memcpy(cached->data(), src_ptr, dst_size);
+        else for (size_t row = 0; row < TILE_PIX_LENGTH / scale; ++row)
+            memcpy(static_cast<BYTE*>(cached->data()) + row * row_bytes,
+                   src_ptr + row * pitch, row_bytes);
+        _tileCache.insert(cache_key, cached);
+    }
+    
     return dst_buffer;
 }
+Buffer __INTERNAL__Slide::read_slide_tile(const SlideTileReadInfo &info) const
+{
+    auto lock = _file->read_lock();
+    
+    return decompress_slide_tile(info.layerIndex, info.tileIndex,
+                                 info.desiredFormat, info.optionalDestination);
+}
+Buffer __INTERNAL__Slide::read_slide_tile(const SlideTileReadInfo &info, DecodeScale scale) const
+{
+    auto lock = _file->read_lock();
+    
+    return decompress_slide_tile(info.layerIndex, info.tileIndex,
+                                 info.desiredFormat, info.optionalDestination,
+                                 0, 0, scale);
+}
+SlideTileReadResults __INTERNAL__Slide::read_slide_tiles(const SlideTilesReadInfo &info) const
+{
+    const auto& indices         = info.tileIndices;
+    const auto& destinations    = info.optionalDestinations;
+    if (destinations.size() && destinations.size() != indices.size())
+        throw std::runtime_error
+        ("optionalDestinations in SlideTilesReadInfo must match the number of tile indices");
+    
+    // Block cached files read the batch up front in coalesced ranges
+    if (_file->cache) prefetch_slide_tiles(info.layerIndex, indices);
+    
+    // The resize lock is held by this thread for the whole batch. The workers
+    // decode under its protection and must not take it themselves, as a
+    // pending writer would otherwise deadlock the batch against this thread.
+    auto lock = _file->read_lock();
+    
+    SlideTileReadResults results (indices.size());
+    _context->parallel_for(indices.size(), [&](size_t index) {
+        auto& result        = results[index];
+        result.tileIndex    = indices[index];
+        try {
+            result.pixels   = decompress_slide_tile
+            (info.layerIndex, result.tileIndex, info.desiredFormat,
+             destinations.size() ? destinations[index] : Buffer());
+            result.result   = IRIS_SUCCESS;
+        } catch (std::runtime_error& e) {
+            result.result   = Result (
+                IRIS_FAILURE,
+                "Failed to read slide tile [layer " +
+                std::to_string(info.layerIndex) + ", tile " +
+                std::to_string(result.tileIndex) + "]: " + e.what()
+            );
+        }
+    });
+    
+    return results;
+}
+struct RegionTileRange {
+    uint32_t                    xFirst              = 0;
+    uint32_t                    yFirst              = 0;
+    uint32_t                    columns             = 0;
+    uint32_t                    rows                = 0;
+};
+inline RegionTileRange GET_REGION_TILE_RANGE (const Extent& extent, const SlideRegionReadInfo& info)
+{
+    // Pull the extent and check that the layer in within info
+    if (info.layerIndex >= extent.layers.size())
+        throw std::runtime_error("layer in SlideRegionReadInfo is out of bounds");
+    auto& layer = extent.layers[info.layerIndex];
+    
+    // Check the region lies within the layer tile grid
+    if (!info.width || !info.height) throw std::runtime_error
+        ("region in SlideRegionReadInfo has no area");
+    const uint64_t layer_width  = uint64_t(layer.xTiles) * TILE_PIX_LENGTH;
+    const uint64_t layer_height = uint64_t(layer.yTiles) * TILE_PIX_LENGTH;
+    if (uint64_t(info.xOffset) + info.width  > layer_width ||
+        uint64_t(info.yOffset) + info.height > layer_height)
+        throw std::runtime_error("region in SlideRegionReadInfo extends beyond the layer bounds");
+    
+    const uint32_t x_first  = info.xOffset / TILE_PIX_LENGTH;
+    const uint32_t y_first  = info.yOffset / TILE_PIX_LENGTH;
+    const uint32_t x_last   = (info.xOffset + info.width  - 1) / TILE_PIX_LENGTH;
+    const uint32_t y_last   = (info.yOffset + info.height - 1) / TILE_PIX_LENGTH;
+    return RegionTileRange {
+        .xFirst     = x_first,
+        .yFirst     = y_first,
+        .columns    = x_last - x_first + 1,
+        .rows       = y_last - y_first + 1,
+    };
+}
+Buffer __INTERNAL__Slide::read_slide_region(const SlideRegionReadInfo &info) const
+{
+    // Block cached files read the region up front in coalesced ranges
+    if (_file->cache) prefetch_slide_region(info);
+    auto lock = _file->read_lock();
+    
+    // Determine the range of tiles touched by the region
+    const auto range        = GET_REGION_TILE_RANGE(_tileTable.extent, info);
+    const auto& layer       = _tileTable.extent.layers[info.layerIndex];
+    const uint32_t x_first  = range.xFirst;
+    const uint32_t y_first  = range.yFirst;
+    const uint32_t columns  = range.columns;
+    const uint32_t rows     = range.rows;
+    
+    size_t bpp = 0;
+    switch (info.desiredFormat) {
+        case FORMAT_UNDEFINED: throw std::runtime_error
+            ("desired format in SlideRegionReadInfo is undefined");
+        case Iris::FORMAT_B8G8R8:
+        case Iris::FORMAT_R8G8B8:
+            bpp = 3;
+            break;
+        case Iris::FORMAT_B8G8R8A8:
+        case Iris::FORMAT_R8G8B8A8:
+            bpp = 4;
+            break;
+    } if (!bpp) throw std::runtime_error
+        ("invalid desired slide format in SlideRegionReadInfo");
+    
+    // Initialize the stitched write destination
+    const size_t pitch      = size_t(info.width) * bpp;
+    const size_t dst_size   = pitch * info.height;
+    Buffer dst_buffer       = nullptr;
+    if (info.optionalDestination && info.optionalDestination->capacity() >= dst_size)
+            dst_buffer = info.optionalDestination;
+    else    dst_buffer = Iris::Create_strong_buffer(dst_size);
+    dst_buffer->set_size(dst_size);
+    BYTE* const dst_ptr     = static_cast<BYTE*>(dst_buffer->data());
+    
+    _context->parallel_for(size_t(columns) * rows, [&](size_t index) {
+        const uint32_t tile_x   = x_first + uint32_t(index % columns);
+        const uint32_t tile_y   = y_first + uint32_t(index / columns);
+        const uint32_t tile_indx= tile_y * layer.xTiles + tile_x;
+        
+        // Intersect the tile with the region in layer pixel space
+        const uint32_t tile_l   = tile_x * TILE_PIX_LENGTH;
+        const uint32_t tile_t   = tile_y * TILE_PIX_LENGTH;
+        const uint32_t left     = std::max(tile_l, info.xOffset);
+        const uint32_t top      = std::max(tile_t, info.yOffset);
+        const uint32_t right    = std::min(tile_l + TILE_PIX_LENGTH, info.xOffset + info.width);
+        const uint32_t bottom   = std::min(tile_t + TILE_PIX_LENGTH, info.yOffset + info.height);
+        const size_t   dst_offset = size_t(top - info.yOffset) * pitch +
+                                    size_t(left - info.xOffset) * bpp;
+        
+        // Interior tiles decode straight into the stitched image
+        if (right - left == TILE_PIX_LENGTH && bottom - top == TILE_PIX_LENGTH) {
+            decompress_slide_tile(info.layerIndex, tile_indx, info.desiredFormat,
+                                  dst_buffer, dst_offset, pitch);
+            return;
+        }
+        
+        // Edge tiles decode into a per-thread scratch tile and only the
+        // rows and columns within the region are copied out.
+        thread_local Buffer scratch = Iris::Create_strong_buffer(TILE_PIX_AREA * 4);
+        auto tile = decompress_slide_tile(info.layerIndex, tile_indx,
+                                          info.desiredFormat, scratch);
+        const size_t tile_pitch = size_t(TILE_PIX_LENGTH) * bpp;
+        const BYTE*  src_ptr    = static_cast<const BYTE*>(tile->data()) +
+                                  size_t(top - tile_t) * tile_pitch +
+                                  size_t(left - tile_l) * bpp;
+        const size_t row_bytes  = size_t(right - left) * bpp;
+        for (uint32_t row = top; row < bottom; ++row, src_ptr += tile_pitch)
+            memcpy(dst_ptr + dst_offset + size_t(row - top) * pitch, src_ptr, row_bytes);
+    });
+    
+    return dst_buffer;
+}
+void __INTERNAL__Slide::prefetch_slide_tiles(uint32_t layer, std::span<const uint32_t> tile_indices) const
+{
+    FileAdviseInfo advise_info {
+        .advice = FILE_ADVICE_WILL_NEED
+    };
+    advise_info.ranges.reserve(tile_indices.size());
+    {   // Gather the ranges; advise_file takes its own lock
+        auto lock = _file->read_lock();
+        for (auto tile_indx : tile_indices) {
+            const auto entry = get_tile_entry(layer, tile_indx);
+            advise_info.ranges.emplace_back(entry.offset, entry.size);
+        }
+    }
+    
+    auto result = advise_file(_file, advise_info);
+    if (result != IRIS_SUCCESS)
+        throw std::runtime_error(result.message);
+}
+void __INTERNAL__Slide::prefetch_slide_region(const SlideRegionReadInfo &info) const
+{
+    auto& extent        = _tileTable.extent;
+    const auto range    = GET_REGION_TILE_RANGE(extent, info);
+    const auto x_tiles  = extent.layers[info.layerIndex].xTiles;
+    
+    std::vector<uint32_t> tile_indices;
+    tile_indices.reserve(size_t(range.columns) * range.rows);
+    for (uint32_t row = 0; row < range.rows; ++row)
+        for (uint32_t column = 0; column < range.columns; ++column)
+            tile_indices.push_back((range.yFirst + row) * x_tiles + range.xFirst + column);
+    
+    prefetch_slide_tiles(info.layerIndex, tile_indices);
+}
+void __INTERNAL__Slide::evict_slide_layer(uint32_t layer) const
+{
+    auto& layers = _tileTable.extent.layers;
+    if (layer >= layers.size())
+        throw std::runtime_error("layer in evict_slide_layer is out of bounds");
+    // Multiply in 64 bits; a layer's tiles must still fit a tile index
+    const uint64_t tiles = static_cast<uint64_t>(layers[layer].xTiles) * layers[layer].yTiles;
+    if (tiles > UINT32_MAX) throw std::runtime_error
+        ("layer in evict_slide_layer holds more tiles than a tile index can address");
+    
+    // Tiles of a layer are typically contiguous; the advise call coalesces
+    // them into very few ranges.
+    FileAdviseInfo advise_info {
+        .advice = FILE_ADVICE_DONT_NEED
+    };
+    advise_info.ranges.reserve(tiles);
+    {   // Gather the ranges; advise_file takes its own lock
+        auto lock = _file->read_lock();
+        for (uint32_t tile_indx = 0; tile_indx < tiles; ++tile_indx) {
+            const auto entry = get_tile_entry(layer, tile_indx);
+            advise_info.ranges.emplace_back(entry.offset, entry.size);
+        }
+    }
+    
+    auto result = advise_file(_file, advise_info);
+    if (result != IRIS_SUCCESS)
+        throw std::runtime_error(result.message);
+}
+void __INTERNAL__Slide::set_tile_cache_budget(size_t bytes) const
+{
+    _tileCache.set_budget(bytes);
+}
+TileCacheStats __INTERNAL__Slide::get_tile_cache_stats() const
+{
+    return _tileCache.get_stats();
+}
+SlideValidationReport __INTERNAL__Slide::validate_slide_tiles(const SlideValidationOptions &options) const
+{
+    const float fraction = options.sampleFraction;
+    if (!(fraction > 0.f && fraction <= 1.f)) throw std::runtime_error
+        ("sampleFraction in SlideValidationOptions must be greater than 0 and at most 1");
+    
+    // Gather the tiles to check. Samples follow the golden ratio sequence
+    // so that they are spread evenly over each layer and stable between runs.
+    struct Target {
+        uint32_t                layer;
+        uint32_t                tile;
+    };
+    std::vector<Target> targets;
+    const auto& layers = _tileTable.extent.layers;
+    for (uint32_t layer = 0; layer < layers.size(); ++layer) {
+        // Multiply in 64 bits; a layer's tiles must still fit a tile index
+        const uint64_t tiles = static_cast<uint64_t>(layers[layer].xTiles) * layers[layer].yTiles;
+        if (tiles > UINT32_MAX) throw std::runtime_error
+            ("layer " + std::to_string(layer) + " holds more tiles than a tile index can address");
+        for (uint32_t tile = 0; tile < tiles; ++tile)
+            if (fraction >= 1.f || std::fmod(tile * 0.6180339887498949, 1.0) < fraction)
+                targets.push_back(Target {layer, tile});
+    }
+    
+    SlideValidationReport report;
+    Mutex           failures_mutex;
+    atomic_uint64   bytes_read  (0);
+    const auto      start       = std::chrono::steady_clock::now();
+    {
+        // Tiles are decoded directly, bypassing the decoded tile cache, so
+        // that every checked tile is decoded and the cache is not churned.
+        auto lock = _file->read_lock();
+        _context->parallel_for(targets.size(), [&](size_t index) {
+            const auto& target = targets[index];
+            try {
+                const auto entry = get_tile_entry(target.layer, target.tile);
+                if (entry.size == 0) throw std::runtime_error
+                    ("tile entry holds no bytes");
+                if (entry.offset + entry.size > _file->size) throw std::runtime_error
+                    ("tile entry extends beyond the end of the file");
+                auto bytes = get_tile_bytes(entry);
+                bytes_read.fetch_add(entry.size, std::memory_order_relaxed);
+                
+                thread_local Buffer scratch = Iris::Create_strong_buffer(TILE_PIX_AREA * 4);
+                auto pixels = _context->decompress_tile({
+                    .compressed             = bytes,
+                    .optionalDestination    = scratch,
+                    .desiredFormat          = Iris::FORMAT_R8G8B8A8,
+                    .encoding               = _tileTable.encoding,
+                });
+                if (!pixels) throw std::runtime_error
+                    ("tile failed to decode");
+                if (pixels->size() != TILE_PIX_AREA * 4) throw std::runtime_error
+                    ("decoded tile holds " + std::to_string(pixels->size()) +
+                     " bytes rather than a full RGBA tile");
+            } catch (std::runtime_error &e) {
+                const auto x_tiles = layers[target.layer].xTiles;
+                MutexLock __ (failures_mutex);
+                report.failures.push_back(SlideTileFailure {
+                    .layer      = target.layer,
+                    .tile       = target.tile,
+                    .x          = target.tile % x_tiles,
+                    .y          = target.tile / x_tiles,
+                    .message    = e.what(),
+                });
+            }
+        });
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    
+    std::sort(report.failures.begin(), report.failures.end(),
+              [](const SlideTileFailure& a, const SlideTileFailure& b) {
+        return a.layer != b.layer ? a.layer < b.layer : a.tile < b.tile;
+    });
+    report.tilesChecked         = targets.size();
+    report.tilesFailed          = report.failures.size();
+    report.bytesRead            = bytes_read.load();
+    report.seconds              = elapsed.count();
+    if (report.seconds > 0.0) {
+        report.tilesPerSecond       = report.tilesChecked / report.seconds;
+        report.megabytesPerSecond   = report.bytesRead / 1E6 / report.seconds;
+    }
+    return report;
+}
 AssociatedImageInfo __INTERNAL__Slide::get_assoc_image_info (const std::string &image_label) const
 {
-    ReadLock lock (_file->resize);
+    // Abstract before locking; the abstraction takes the lock itself
+    const auto& images   = get_abstraction().images;
+    auto lock = _file->read_lock();
     
-    const auto image_itr = _abstraction.images.find(image_label);
-    if (image_itr == _abstraction.images.cend())
+    const auto image_itr = images.find(image_label);
+    if (image_itr == images.cend())
         throw std::runtime_error("get_assoc_image_info failed as there is no image with label \""+
                                  image_label + "\" within the slide file.");
     
@@ -322,27 +1240,54 @@ AssociatedImageInfo __INTERNAL__Slide::get_assoc_image_info (const std::string &
 }
 Buffer __INTERNAL__Slide::get_assoc_image (const std::string &image_label) const
 {
-    ReadLock lock (_file->resize);
+    // Abstract before locking; the abstraction takes the lock itself
+    const auto& images   = get_abstraction().images;
+    auto lock = _file->read_lock();
     
-    const auto image_itr = _abstraction.images.find(image_label);
-    if (image_itr == _abstraction.images.cend())
+    const auto image_itr = images.find(image_label);
+    if (image_itr == images.cend())
         throw std::runtime_error("get_assoc_image failed as there is no image with label \""+
                                  image_label + "\" within the slide file.");
     
     const auto& entry = image_itr->second;
-    return Copy_strong_buffer_from_data(_file->ptr + entry.offset, entry.byteSize);
+    auto bytes = get_file_bytes(entry.offset, entry.byteSize);
+    // Block cached reads are already an owned copy
+    if (_file->cache) return bytes;
+    return Copy_strong_buffer_from_data(bytes->data(), bytes->size());
+}
+MappedView __INTERNAL__Slide::get_assoc_image_view (const std::string &image_label) const
+{
+    // Abstract before locking; the abstraction takes the lock itself
+    const auto& images   = get_abstraction().images;
+    // The lease holds the resize lock for as long as the view is alive
+    auto lease = std::make_shared<__INTERNAL__FileLock>(_file);
+    
+    const auto image_itr = images.find(image_label);
+    if (image_itr == images.cend())
+        throw std::runtime_error("get_assoc_image_view failed as there is no image with label \""+
+                                 image_label + "\" within the slide file.");
+    
+    // (block cached files return an owned copy; the lease is then moot)
+    const auto& entry = image_itr->second;
+    return MappedView {
+        .bytes  = get_file_bytes(entry.offset, entry.byteSize),
+        .offset = entry.offset,
+        .lease  = lease,
+    };
 }
 Buffer __INTERNAL__Slide::read_assc_image (const AssociatedImageReadInfo &info) const
 {
-    ReadLock lock (_file->resize);
+    // Abstract before locking; the abstraction takes the lock itself
+    const auto& images   = get_abstraction().images;
+    auto lock = _file->read_lock();
     
-    const auto image_itr = _abstraction.images.find(info.imageLabel);
-    if (image_itr == _abstraction.images.cend())
+    const auto image_itr = images.find(info.imageLabel);
+    if (image_itr == images.cend())
         throw std::runtime_error("get_assoc_image failed as there is no image with label \""+
                                  info.imageLabel + "\" within the slide file.");
     
     const auto& entry   = image_itr->second;
-    Buffer src          = Iris::Wrap_weak_buffer_fom_data (_file->ptr + entry.offset, entry.byteSize);
+    Buffer src          = get_file_bytes(entry.offset, entry.byteSize);
     
     // Initialize the write destination
     Buffer dst_buffer   = nullptr;
@@ -8,28 +8,102 @@
 #ifndef IrisCodecSlide_hpp
 #define IrisCodecSlide_hpp
 namespace IrisCodec {
+/// In-place index over a slide's on-disk tile table.
+///
+/// Only the tile table header fields and the position of each layer within
+/// the flat TILE_OFFSETS array are held in memory. Tile entries are decoded
+/// on demand directly from the mapped array, so indexing a slide is
+/// O(layers) rather than O(tiles).
+struct __INTERNAL__TileTableIndex {
+    Encoding                                    encoding    = TILE_ENCODING_UNDEFINED;
+    Format                                      format      = Iris::FORMAT_UNDEFINED;
+    Extent                                      extent;
+    Offset                                      entries     = NULL_OFFSET;  // File offset of entry zero
+    std::vector<uint64_t>                       layerFirst;                 // First entry of each layer + total
+};
+/// Context independent state of an opened slide file: its mapping, tile
+/// table index and (lazily) abstracted metadata. Slides opened on the same
+/// file within the process share one rather than each mapping the file.
+struct __INTERNAL__SlideFile {
+    const File                                  file;
+    const Offset                                structure;  // Block cached files: start of the loaded structure
+    const __INTERNAL__TileTableIndex            tileTable;
+    std::once_flag                              abstracted;
+    Abstraction::File                           abstraction;
+    explicit __INTERNAL__SlideFile              (const File&, Offset structure = 0);
+    __INTERNAL__SlideFile                       (const __INTERNAL__SlideFile&) = delete;
+    __INTERNAL__SlideFile operator =            (const __INTERNAL__SlideFile&) = delete;
+};
+using SlideFile = std::shared_ptr<__INTERNAL__SlideFile>;
 class __INTERNAL__Slide {
     const Context                               _context;
+    const SlideFile                             _shared;
     const File                                  _file;
-    const Abstraction::File                     _abstraction;
+    const __INTERNAL__TileTableIndex&           _tileTable;
+    mutable __INTERNAL__TileCache               _tileCache;
+    
+    // Look up a tile entry within the mapped tile table.
+    Abstraction::TileEntry get_tile_entry       (uint32_t layer, uint32_t tile_indx) const;
+    // Read a byte range of the slide file. Mapped files return a view
+    // valid under the file resize lock; block cached files an owned copy.
+    Buffer              get_file_bytes          (Offset, Size) const;
+    // Read the compressed bytes of a tile entry (as get_file_bytes)
+    Buffer              get_tile_bytes          (const Abstraction::TileEntry&) const;
+    // Abstract the metadata and associated images on first use. The caller
+    // must not hold the file resize lock.
+    const Abstraction::File& get_abstraction    () const;
+    // Decompress a tile entry, optionally at an offset and row pitch within
+    // the destination. The caller must hold the file resize lock.
+    Buffer              decompress_slide_tile   (uint32_t layer, uint32_t tile_indx,
+                                                 Format, const Buffer& destination,
+                                                 size_t offset = 0, size_t pitch = 0,
+                                                 DecodeScale = DECODE_SCALE_FULL) const;
 public:
-    explicit __INTERNAL__Slide                  (const Context&, const File&);
+    explicit __INTERNAL__Slide                  (const Context&, const SlideFile&);
     __INTERNAL__Slide                           (const __INTERNAL__Slide&) = delete;
     __INTERNAL__Slide operator =                (const __INTERNAL__Slide&) = delete;
    ~__INTERNAL__Slide                           ();
     
     // Return codec version used to encode the slide
     Version             get_slide_codec_version () const;
-    // Return the slide information
+    // Return the slide information (abstracts the slide metadata)
     SlideInfo           get_slide_info          () const;
+    // Return the slide extent without abstracting the slide metadata
+    const Extent&       get_slide_extent        () const;
+    // Return the slide tile pixel format
+    Format              get_slide_format        () const;
+    // Return the slide tile encoding
+    Encoding            get_slide_encoding      () const;
     // Get the compressed slide tile entry
     Buffer              get_slide_tile_entry    (uint32_t layer, uint32_t tile_indx) const;
+    // Get a zero-copy leased view of the compressed slide tile entry
+    MappedView          get_slide_tile_view     (uint32_t layer, uint32_t tile_indx) const;
     // Read the slide tile entry to return a decompressed tile
     Buffer              read_slide_tile         (const SlideTileReadInfo&) const;
+    // Read the slide tile entry to return a tile decompressed at a reduced scale
+    Buffer              read_slide_tile         (const SlideTileReadInfo&, DecodeScale) const;
+    // Read a batch of slide tile entries decompressed in parallel
+    SlideTileReadResults read_slide_tiles       (const SlideTilesReadInfo&) const;
+    // Read an arbitrary pixel region of a layer stitched into one image
+    Buffer              read_slide_region       (const SlideRegionReadInfo&) const;
+    // Page in the compressed tile entries ahead of access
+    void                prefetch_slide_tiles    (uint32_t layer, std::span<const uint32_t> tiles) const;
+    // Page in the compressed tile entries touched by a pixel region
+    void                prefetch_slide_region   (const SlideRegionReadInfo&) const;
+    // Release resident pages of a layer's compressed tile entries
+    void                evict_slide_layer       (uint32_t layer) const;
+    // Set the decoded tile cache byte budget (zero disables the cache)
+    void                set_tile_cache_budget   (size_t bytes) const;
+    // Get the decoded tile cache statistics
+    TileCacheStats      get_tile_cache_stats    () const;
+    // Decode every (or a sample of every) layer's tiles to check they are intact
+    SlideValidationReport validate_slide_tiles  (const SlideValidationOptions&) const;
     // Get information about an associated image
     AssociatedImageInfo get_assoc_image_info    (const std::string& image_label) const;
     // Get the compressed associated image stream
     Buffer              get_assoc_image         (const std::string& image_label) const;
+    // Get a zero-copy leased view of the compressed associated image stream
+    MappedView          get_assoc_image_view    (const std::string& image_label) const;
     // Read the associated image to return a decompressed image
     Buffer              read_assc_image         (const AssociatedImageReadInfo&) const;
     
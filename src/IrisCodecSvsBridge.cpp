@@ -0,0 +1,373 @@
+/**
+ * @file IrisCodecSvsBridge.cpp
+ * @author Ryan Landvater (ryanlandvater [at] gmail [dot] com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * This file provides a bridge for reading Aperio SVS files in the
+ * Iris Codec Encoder using libtiff directly. Pyramid levels whose
+ * tiles are already 256 px YCbCr JPEG streams are handed to the
+ * encoder compressed, so they may be copied without re-encoding;
+ * all other levels are decoded into 256 px tiles through a pool of
+ * independent TIFF readers so that encoder threads do not serialize.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "IrisCodecPriv.hpp"
+#include <filesystem>
+#include <sstream>
+#include <tiffio.h>
+
+namespace IrisCodec {
+struct SvsLevel {
+    tdir_t      directory   = 0;
+    uint32_t    width       = 0; // Level pixel width
+    uint32_t    height      = 0; // Level pixel height
+    uint32_t    tileWidth   = 0;
+    uint32_t    tileHeight  = 0;
+    bool        passthrough = false; // Tiles are Iris compatible JPEG streams
+    std::string tables;              // Abbreviated JPEG tables (SOI ... EOI)
+};
+struct SvsImage {
+    tdir_t      directory   = 0;
+    uint32_t    width       = 0;
+    uint32_t    height      = 0;
+};
+struct __INTERNAL__SvsFile {
+    using Levels    = std::vector<SvsLevel>;
+    using Images    = std::unordered_map<std::string, SvsImage>;
+    using Readers   = std::vector<TIFF*>;
+    const std::string   _path;
+    Levels              _levels; // ordered from lowest to highest resolution
+    Images              _images;
+    std::string         _description;
+    std::string         _ICC_profile;
+    Mutex               _readersMutex;
+    Readers             _readers; // Idle TIFF handles available for reuse
+    __INTERNAL__SvsFile (const std::string& __p) : _path(__p){}
+    __INTERNAL__SvsFile (const __INTERNAL__SvsFile&) = delete;
+    __INTERNAL__SvsFile operator = (const __INTERNAL__SvsFile&) = delete;
+    ~__INTERNAL__SvsFile ()
+    {
+        for (auto reader : _readers)
+            TIFFClose(reader);
+    }
+};
+// Aperio files carry many private tags and libtiff warns on every one. The
+// warnings are silenced per handle (libtiff 4.5+) rather than by replacing
+// the process wide handler that other libtiff users in the process rely on.
+#if defined(TIFFLIB_VERSION) && TIFFLIB_VERSION >= 20221213
+static int IGNORE_SVS_WARNING (TIFF*, void*, const char*, const char*, va_list)
+{
+    return 1; // Handled; the process wide handler is not called
+}
+inline TIFF* OPEN_SVS_TIFF (const std::string& path)
+{
+    TIFFOpenOptions* options = TIFFOpenOptionsAlloc();
+    if (!options) return NULL;
+    TIFFOpenOptionsSetWarningHandlerExtR(options, IGNORE_SVS_WARNING, NULL);
+    TIFF* tif = TIFFOpenExt(path.c_str(), "r", options);
+    TIFFOpenOptionsFree(options);
+    return tif;
+}
+#else
+inline TIFF* OPEN_SVS_TIFF (const std::string& path)
+{
+    // Older libtiff only has the process wide handler; leave it alone
+    return TIFFOpen(path.c_str(), "r");
+}
+#endif
+// A TIFF handle is not thread safe; each reading thread checks out its own
+// handle from the file's pool and returns it when finished. The pool grows
+// to the number of concurrent readers and is then reused.
+class SvsReader {
+    __INTERNAL__SvsFile&    _file;
+    TIFF*                   _handle = NULL;
+public:
+    explicit SvsReader (__INTERNAL__SvsFile& __f) : _file(__f)
+    {
+        {
+            MutexLock __ (_file._readersMutex);
+            if (_file._readers.size()) {
+                _handle = _file._readers.back();
+                _file._readers.pop_back();
+                return;
+            }
+        }
+        _handle = OPEN_SVS_TIFF(_file._path);
+        if (!_handle) throw std::runtime_error
+            ("Failed to open an additional TIFF reader for " + _file._path);
+    }
+    SvsReader (const SvsReader&) = delete;
+    SvsReader& operator = (const SvsReader&) = delete;
+    ~SvsReader ()
+    {
+        MutexLock __ (_file._readersMutex);
+        _file._readers.push_back(_handle);
+    }
+    TIFF* set_directory (tdir_t directory)
+    {
+        if (TIFFCurrentDirectory(_handle) != directory &&
+            !TIFFSetDirectory(_handle, directory)) throw std::runtime_error
+            ("Failed to select TIFF directory " + std::to_string(directory) +
+             " in " + _file._path);
+        return _handle;
+    }
+};
+inline std::string GET_SVS_DESCRIPTION (TIFF* tif)
+{
+    const char* description = NULL;
+    if (TIFFGetField(tif, TIFFTAG_IMAGEDESCRIPTION, &description) && description)
+        return std::string(description);
+    return std::string();
+}
+inline SvsLevel GET_SVS_LEVEL (TIFF* tif)
+{
+    SvsLevel level;
+    uint16_t compression = COMPRESSION_NONE, photometric = 0;
+    uint16_t samples = 0, bits = 0, planar = PLANARCONFIG_CONTIG;
+    level.directory = TIFFCurrentDirectory(tif);
+    TIFFGetField            (tif, TIFFTAG_IMAGEWIDTH,       &level.width);
+    TIFFGetField            (tif, TIFFTAG_IMAGELENGTH,      &level.height);
+    TIFFGetField            (tif, TIFFTAG_TILEWIDTH,        &level.tileWidth);
+    TIFFGetField            (tif, TIFFTAG_TILELENGTH,       &level.tileHeight);
+    TIFFGetFieldDefaulted   (tif, TIFFTAG_COMPRESSION,      &compression);
+    TIFFGetFieldDefaulted   (tif, TIFFTAG_PHOTOMETRIC,      &photometric);
+    TIFFGetFieldDefaulted   (tif, TIFFTAG_SAMPLESPERPIXEL,  &samples);
+    TIFFGetFieldDefaulted   (tif, TIFFTAG_BITSPERSAMPLE,    &bits);
+    TIFFGetFieldDefaulted   (tif, TIFFTAG_PLANARCONFIG,     &planar);
+
+    // Aperio also writes JPEG 2000 levels, which libtiff cannot decode.
+    // Refuse the file so that the encoder may fall back to OpenSlide.
+    if (!TIFFIsCODECConfigured(compression)) throw std::runtime_error
+        ("SVS level compression scheme (" + std::to_string(compression) +
+         ") is not supported by libtiff");
+
+    // Raw tiles may only be used as-is if they decode to an Iris tile.
+    // RGB photometric JPEG streams lack the markers decoders need to
+    // identify the color space and must be decoded by libtiff instead.
+    level.passthrough   =   compression         == COMPRESSION_JPEG &&
+                            photometric         == PHOTOMETRIC_YCBCR &&
+                            samples             == 3 &&
+                            bits                == 8 &&
+                            planar              == PLANARCONFIG_CONTIG &&
+                            level.tileWidth     == TILE_PIX_LENGTH &&
+                            level.tileHeight    == TILE_PIX_LENGTH;
+    if (level.passthrough) {
+        uint32_t    count   = 0;
+        void*       tables  = NULL;
+        if (TIFFGetField(tif, TIFFTAG_JPEGTABLES, &count, &tables) && count > 4)
+            level.tables = std::string(static_cast<const char*>(tables), count);
+    }
+    return level;
+}
+inline void GET_SVS_ICC_PROFILE (TIFF* tif, std::string& profile)
+{
+    uint32_t    count   = 0;
+    void*       data    = NULL;
+    if (TIFFGetField(tif, TIFFTAG_ICCPROFILE, &count, &data) && count)
+        profile = std::string(static_cast<const char*>(data), count);
+}
+inline const SvsLevel& GET_SVS_LEVEL (const SvsFile& svs, unsigned level)
+{
+    if (level < svs->_levels.size())
+        return svs->_levels[level];
+    throw std::runtime_error("Level "+std::to_string(level)+
+                             " is out of SVS file range.");
+}
+SvsFile open_svs_file (const std::filesystem::path& filePath)
+{
+    TIFF* tif = OPEN_SVS_TIFF(filePath.string());
+    if (!tif) throw std::runtime_error
+        ("libtiff failed to open " + filePath.string());
+
+    auto file = std::make_shared<__INTERNAL__SvsFile>(filePath.string());
+    file->_readers.push_back(tif); // Closed with the file (in case error thrown)
+
+    file->_description = GET_SVS_DESCRIPTION(tif);
+    if (file->_description.rfind("Aperio", 0) != 0) throw std::runtime_error
+        ("TIFF image description does not identify an Aperio slide");
+    GET_SVS_ICC_PROFILE(tif, file->_ICC_profile);
+
+    // Tiled directories are pyramid levels. Stripped directories are the
+    // associated images: the thumbnail follows the base level while the
+    // label and macro images name themselves in their descriptions.
+    auto& levels = file->_levels;
+    auto& images = file->_images;
+    do {
+        if (TIFFIsTiled(tif)) {
+            levels.push_back(GET_SVS_LEVEL(tif));
+            continue;
+        }
+        SvsImage image;
+        image.directory = TIFFCurrentDirectory(tif);
+        TIFFGetField(tif, TIFFTAG_IMAGEWIDTH,  &image.width);
+        TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &image.height);
+        auto description = GET_SVS_DESCRIPTION(tif);
+        if (description.find("label") != std::string::npos)
+            images["label"] = image;
+        else if (description.find("macro") != std::string::npos)
+            images["macro"] = image;
+        else if (images.count("thumbnail") == 0 && levels.size())
+            images["thumbnail"] = image;
+    } while (TIFFReadDirectory(tif));
+
+    if (!levels.size()) throw std::runtime_error
+        ("Following parsing, there are no viable layers within this SVS file.");
+
+    // Sort levels from lowest to highest resolution
+    std::sort(levels.begin(), levels.end(), [](const SvsLevel& a, const SvsLevel& b) {
+        return static_cast<uint64_t>(a.width)*a.height < static_cast<uint64_t>(b.width)*b.height;
+    });
+
+    return file;
+}
+uint32_t get_svs_number_of_levels (SvsFile svs)
+{
+    return U32_CAST(svs->_levels.size());
+}
+uint32_t get_svs_layer_width (SvsFile svs, unsigned level)
+{
+    return GET_SVS_LEVEL(svs, level).width;
+}
+uint32_t get_svs_layer_height (SvsFile svs, unsigned level)
+{
+    return GET_SVS_LEVEL(svs, level).height;
+}
+Encoding get_svs_encoding (SvsFile svs)
+{
+    for (auto& level : svs->_levels)
+        if (level.passthrough) return TILE_ENCODING_JPEG;
+    return TILE_ENCODING_UNDEFINED;
+}
+Buffer get_svs_tile_stream (SvsFile svs, unsigned levelIndex, unsigned tileIndex)
+{
+    auto& level = GET_SVS_LEVEL(svs, levelIndex);
+    if (level.passthrough == false) return NULL;
+
+    SvsReader reader (*svs);
+    auto tif = reader.set_directory(level.directory);
+    uint64_t* byte_counts = NULL;
+    if (!TIFFGetField(tif, TIFFTAG_TILEBYTECOUNTS, &byte_counts) || !byte_counts)
+        throw std::runtime_error("SVS level is missing its tile byte counts");
+    const auto tile_bytes = byte_counts[tileIndex];
+    if (tile_bytes < 4) return NULL;
+
+    // Abbreviated tiles must be merged with the level's shared tables:
+    // the tables less their EOI followed by the tile less its SOI. The
+    // tile is read in place over the tables' last two bytes, which are
+    // then restored over the tile's SOI marker.
+    const auto& tables  = level.tables;
+    const auto  prefix  = tables.size() ? tables.size() - 4 : 0;
+    auto buffer = Create_strong_buffer(prefix + tile_bytes);
+    auto __ptr  = static_cast<BYTE*>(buffer->append(prefix + tile_bytes));
+    memcpy(__ptr, tables.data(), prefix);
+    if (TIFFReadRawTile(tif, tileIndex, __ptr + prefix, tile_bytes) != tile_bytes)
+        throw std::runtime_error("Failed to read SVS tile " + std::to_string(tileIndex));
+    if (prefix) memcpy(__ptr + prefix, tables.data() + prefix, 2);
+    return buffer;
+}
+// Decodes into the given buffer, which must be empty and able to hold an RGBA tile
+Buffer read_svs_tile (SvsFile svs, unsigned levelIndex, unsigned tileIndex, Buffer buffer)
+{
+    auto& level = GET_SVS_LEVEL(svs, levelIndex);
+    const auto x_tiles  = (level.width  + TILE_PIX_LENGTH - 1) / TILE_PIX_LENGTH;
+    const auto col      = (tileIndex % x_tiles) * TILE_PIX_LENGTH;
+    const auto row      = (tileIndex / x_tiles) * TILE_PIX_LENGTH;
+    if (col >= level.width || row >= level.height) throw std::runtime_error
+        ("Tile " + std::to_string(tileIndex) + " is out of SVS level range.");
+    const auto width    = std::min<uint32_t>(TILE_PIX_LENGTH, level.width  - col);
+    const auto height   = std::min<uint32_t>(TILE_PIX_LENGTH, level.height - row);
+
+    SvsReader reader (*svs);
+    auto tif = reader.set_directory(level.directory);
+    char error_msg[1024];
+    TIFFRGBAImage image;
+    if (!TIFFRGBAImageBegin(&image, tif, 0, error_msg)) throw std::runtime_error
+        ("Failed to begin SVS tile decode: " + std::string(error_msg));
+    image.req_orientation   = ORIENTATION_TOPLEFT;
+    image.col_offset        = static_cast<int>(col);
+    image.row_offset        = static_cast<int>(row);
+
+    // libtiff packs pixels as ABGR words, which are R8G8B8A8 in memory
+    // on little-endian hosts. Edge tiles are decoded into scratch space
+    // and copied into the zero-padded full size tile.
+    auto __ptr  = static_cast<uint32_t*>(buffer->append(TILE_PIX_BYTES_RGBA));
+    int  result = 0;
+    if (width == TILE_PIX_LENGTH && height == TILE_PIX_LENGTH)
+        result = TIFFRGBAImageGet(&image, __ptr, width, height);
+    else {
+        thread_local std::vector<uint32_t> scratch;
+        scratch.resize(width * height);
+        result = TIFFRGBAImageGet(&image, scratch.data(), width, height);
+        memset(__ptr, 0, TILE_PIX_BYTES_RGBA);
+        for (uint32_t y = 0; y < height; ++y)
+            memcpy(__ptr + y * TILE_PIX_LENGTH, scratch.data() + y * width,
+                   width * sizeof(uint32_t));
+    }
+    TIFFRGBAImageEnd(&image);
+    if (!result) throw std::runtime_error
+        ("Failed to decode SVS tile " + std::to_string(tileIndex));
+    return buffer;
+}
+AssociatedImageInfo get_svs_associated_image_info (SvsFile svs, const std::string& label)
+{
+    auto image = svs->_images.find(label);
+    if (image == svs->_images.end()) throw std::runtime_error
+        ("SVS file does not contain an associated image labeled " + label);
+    return AssociatedImageInfo {
+        .imageLabel     = label,
+        .width          = image->second.width,
+        .height         = image->second.height,
+        .encoding       = IMAGE_ENCODING_DEFAULT,
+        .sourceFormat   = Iris::FORMAT_R8G8B8A8, // libtiff RGBA words (little-endian)
+        .orientation    = ORIENTATION_0
+    };
+}
+Buffer read_svs_associated_image (SvsFile svs, const AssociatedImageInfo& info)
+{
+    auto image = svs->_images.find(info.imageLabel);
+    if (image == svs->_images.end()) throw std::runtime_error
+        ("SVS file does not contain an associated image labeled " + info.imageLabel);
+
+    SvsReader reader (*svs);
+    auto tif        = reader.set_directory(image->second.directory);
+    size_t bytes    = static_cast<size_t>(info.width) * info.height * sizeof(uint32_t);
+    Buffer dst      = Create_strong_buffer(bytes);
+    if (!TIFFReadRGBAImageOriented(tif, info.width, info.height,
+                                   static_cast<uint32_t*>(dst->append(bytes)),
+                                   ORIENTATION_TOPLEFT, 0))
+        throw std::runtime_error("Failed to decode SVS associated image " + info.imageLabel);
+    return dst;
+}
+// The Aperio image description is a '|' delimited list. The first field
+// describes the image library and the remainder are 'key = value' pairs.
+Metadata get_svs_metadata (SvsFile svs, bool anonymize)
+{
+    Metadata metadata;
+    metadata.attributes.type = METADATA_FREE_TEXT;
+
+    std::stringstream description (svs->_description);
+    std::string field;
+    std::getline(description, field, '|');
+    while (std::getline(description, field, '|')) {
+        auto split = field.find(" = ");
+        if (split == std::string::npos) continue;
+        auto key   = field.substr(0, split);
+        auto value = field.substr(split + 3);
+        if (key == "MPP")       metadata.micronsPerPixel = atof(value.c_str());
+        if (key == "AppMag")    metadata.magnification   = atof(value.c_str());
+        if (anonymize)          continue;
+        metadata.attributes["aperio." + key] = std::u8string(value.begin(), value.end());
+    }
+
+    for (auto& image : svs->_images)
+        if (!anonymize || image.first == "thumbnail")
+            metadata.associatedImages.insert(image.first);
+
+    metadata.ICC_profile = svs->_ICC_profile;
+    return metadata;
+}
+} // END IRIS CODEC NAMESPACE
@@ -0,0 +1,136 @@
+//
+//  IrisCodecTileCache.cpp
+//  Iris
+//
+//  Created by Ryan Landvater on 10/17/26.
+//
+#include "IrisCodecPriv.hpp"
+
+namespace IrisCodec {
+__INTERNAL__TileCache::__INTERNAL__TileCache (size_t budget) :
+_budget                                     (budget),
+_hits                                       (0),
+_misses                                     (0),
+_evictions                                  (0),
+_bytes                                      (0),
+_entries                                    (0)
+{
+    
+}
+__INTERNAL__TileCache::Key __INTERNAL__TileCache::make_key (uint32_t layer, uint32_t tile,
+                                                           Format format, DecodeScale scale)
+{
+    // Tile indices occupy the low word; layers, formats and scales are small
+    return  (static_cast<Key>(layer  & 0xFFFFFF) << 40) |
+            (static_cast<Key>(scale  & 0x0F)     << 36) |
+            (static_cast<Key>(format & 0x0F)     << 32) |
+             static_cast<Key>(tile);
+}
+__INTERNAL__TileCache::Shard& __INTERNAL__TileCache::get_shard (Key key)
+{
+    // Neighbouring tiles share every bit but the lowest, so mix before
+    // selecting a shard to spread a viewport across all of them.
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDULL;
+    key ^= key >> 33;
+    return _shards[key % SHARDS];
+}
+bool __INTERNAL__TileCache::enabled () const
+{
+    return _budget.load(std::memory_order_relaxed) > 0;
+}
+void __INTERNAL__TileCache::evict_to (Shard& shard, size_t budget, size_t keep)
+{
+    // Caller must hold the shard lock. The budget spans every shard; this
+    // one gives up its least recently used tiles until the whole cache fits
+    // or only `keep` of its entries remain.
+    while (_bytes.load(std::memory_order_relaxed) > budget && shard.entries.size() > keep) {
+        auto& oldest = shard.entries.back();
+        const size_t size = oldest.second->size();
+        shard.lookup.erase(oldest.first);
+        shard.entries.pop_back();
+        shard.bytes -= size;
+        _bytes.fetch_sub(size, std::memory_order_relaxed);
+        _entries.fetch_sub(1, std::memory_order_relaxed);
+        _evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+bool __INTERNAL__TileCache::read (Key key, BYTE* destination, size_t pitch)
+{
+    if (!enabled()) return false;
+    
+    auto& shard = get_shard(key);
+    MutexLock lock (shard.mutex);
+    auto itr = shard.lookup.find(key);
+    if (itr == shard.lookup.end()) {
+        _misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    
+    // Promote the entry to most recently used
+    shard.entries.splice(shard.entries.begin(), shard.entries, itr->second);
+    
+    // Copy the tile out, row by row if the destination is pitched
+    const auto& pixels  = itr->second->second;
+    const auto  src     = static_cast<const BYTE*>(pixels->data());
+    const auto  size    = pixels->size();
+    const auto  row     = size / TILE_PIX_LENGTH; // Pitched reads are full scale
+    if (pitch == 0 || pitch == row)
+        memcpy(destination, src, size);
+    else for (size_t y = 0; y < TILE_PIX_LENGTH; ++y)
+        memcpy(destination + y * pitch, src + y * row, row);
+    
+    _hits.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+void __INTERNAL__TileCache::insert (Key key, const Buffer& pixels)
+{
+    const size_t budget = _budget.load(std::memory_order_relaxed);
+    if (!pixels || pixels->size() > budget) return;
+    
+    auto& local = get_shard(key);
+    {
+        MutexLock lock (local.mutex);
+        
+        // Another reader may have decoded and inserted the same tile
+        if (local.lookup.contains(key)) return;
+        
+        local.entries.emplace_front(key, pixels);
+        local.lookup.emplace(key, local.entries.begin());
+        local.bytes += pixels->size();
+        _bytes.fetch_add(pixels->size(), std::memory_order_relaxed);
+        _entries.fetch_add(1, std::memory_order_relaxed);
+        
+        // Evict from this shard first, keeping the tile just inserted
+        evict_to(local, budget, 1);
+    }
+    
+    // Take any remaining overrun from the other shards, one lock at a time
+    for (auto& shard : _shards) {
+        if (_bytes.load(std::memory_order_relaxed) <= budget) break;
+        if (&shard == &local) continue;
+        MutexLock lock (shard.mutex);
+        evict_to(shard, budget, 0);
+    }
+}
+void __INTERNAL__TileCache::set_budget (size_t bytes)
+{
+    _budget.store(bytes, std::memory_order_relaxed);
+    for (auto& shard : _shards) {
+        if (_bytes.load(std::memory_order_relaxed) <= bytes) break;
+        MutexLock lock (shard.mutex);
+        evict_to(shard, bytes, 0);
+    }
+}
+TileCacheStats __INTERNAL__TileCache::get_stats () const
+{
+    return TileCacheStats {
+        .budget     = _budget.load(std::memory_order_relaxed),
+        .bytes      = _bytes.load(std::memory_order_relaxed),
+        .entries    = _entries.load(std::memory_order_relaxed),
+        .hits       = _hits.load(std::memory_order_relaxed),
+        .misses     = _misses.load(std::memory_order_relaxed),
+        .evictions  = _evictions.load(std::memory_order_relaxed),
+    };
+}
+} // END IRIS CODEC NAMESPACE
@@ -0,0 +1,61 @@
+//
+//  IrisCodecTileCache.hpp
+//  Iris
+//
+//  Created by Ryan Landvater on 10/17/26.
+//
+
+#ifndef IrisCodecTileCache_hpp
+#define IrisCodecTileCache_hpp
+namespace IrisCodec {
+/// Least-recently-used cache of decompressed slide tiles with a byte budget.
+///
+/// Entries are keyed by (layer, tile, format, scale) and spread across independently
+/// locked shards so concurrent readers of different tiles rarely contend.
+/// The byte budget is accounted across all shards rather than split between
+/// them, so any budget that holds a single tile caches tiles; an insert
+/// evicts from its own shard first and only then from the others.
+/// Cached pixel buffers are never handed out; hits are copied into the
+/// caller's destination so cached tiles cannot be mutated after insertion.
+/// A budget of zero disables the cache entirely.
+class __INTERNAL__TileCache {
+public:
+    using Key                           = uint64_t;
+    static constexpr size_t SHARDS      = 16;
+private:
+    using Entry                         = std::pair<Key, Buffer>;
+    using Entries                       = std::list<Entry>;
+    struct alignas(64) Shard {
+        Mutex                           mutex;
+        Entries                         entries;    // Front is most recently used
+        std::unordered_map<Key, Entries::iterator> lookup;
+        size_t                          bytes       = 0;
+    };
+    std::atomic<size_t>                 _budget;
+    Shard                               _shards     [SHARDS];
+    atomic_uint64                       _hits;
+    atomic_uint64                       _misses;
+    atomic_uint64                       _evictions;
+    atomic_uint64                       _bytes;
+    atomic_uint64                       _entries;
+    
+    Shard&      get_shard               (Key);
+    void        evict_to                (Shard&, size_t budget, size_t keep);
+public:
+    explicit __INTERNAL__TileCache      (size_t budget);
+    __INTERNAL__TileCache               (const __INTERNAL__TileCache&) = delete;
+    __INTERNAL__TileCache operator =    (const __INTERNAL__TileCache&) = delete;
+    
+    static Key  make_key                (uint32_t layer, uint32_t tile, Format,
+                                         DecodeScale = DECODE_SCALE_FULL);
+    bool        enabled                 () const;
+    // Copy a cached tile into the destination with the given row pitch
+    // (zero for tightly packed). Returns false on a cache miss.
+    bool        read                    (Key, BYTE* destination, size_t pitch);
+    // Insert a tightly packed decompressed tile; the cache takes ownership.
+    void        insert                  (Key, const Buffer& pixels);
+    void        set_budget              (size_t bytes);
+    TileCacheStats get_stats            () const;
+};
+} // END IRIS CODEC NAMESPACE
+#endif /* IrisCodecTileCache_hpp */